@@ -1,4 +1,5 @@
 #include "AppClass.h"
+#include <cassert>
 using namespace Simplex;
 void Application::InitVariables(void)
 {
@@ -22,6 +23,10 @@ void Application::InitVariables(void)
 	m_pSteve = new Model();
 	m_pSteve->Load("Minecraft\\Steve.obj");
 	m_pSteveRB = new MyRigidBody(m_pSteve->GetVertexList());
+
+	//the batched SAT only sees one pair per frame here, so it is checked against SAT
+	//on random batches of every size once at start up
+	assert(MyRigidBody::CheckSATBatch());
 }
 void Application::Update(void)
 {
@@ -46,7 +51,12 @@ void Application::Update(void)
 	m_pSteveRB->SetModelMatrix(mSteve);
 	m_pMeshMngr->AddAxisToRenderList(mSteve);
 
-	bool bColliding = m_pCreeperRB->IsColliding(m_pSteveRB);
+	//count the pairs each collision tier settles this frame, the pairs that reach SAT are
+	//tested together
+	MyRigidBody::ResetTierCount();
+	MyRigidBody* pPairList[] = { m_pCreeperRB, m_pSteveRB };
+	bool bColliding = false;
+	MyRigidBody::CheckCollisions(pPairList, 1, &bColliding);
 
 	m_pCreeper->AddToRenderList();
 	m_pCreeperRB->AddToRenderList();
@@ -46,6 +46,10 @@ void Application::DrawGUI(void)
 			ImGui::Text(" Shift: Modify Up/Down\n");
 			ImGui::Separator();
 			ImGui::TextColored(ImColor(255, 255, 0), "SAT is checked.\n");
+			ImGui::Text("Rejected by Sphere: %u\n", MyRigidBody::GetTierCount(CT_SPHERE));
+			ImGui::Text("Rejected by ARBB: %u\n", MyRigidBody::GetTierCount(CT_ARBB));
+			ImGui::Text("Rejected by SAT: %u\n", MyRigidBody::GetTierCount(CT_SAT));
+			ImGui::Text("Colliding: %u\n", MyRigidBody::GetTierCount(CT_COLLIDING));
 		}
 		ImGui::End();
 	}
@@ -1,5 +1,11 @@
 #include "MyRigidBody.h"
+#include <immintrin.h>
+#include <random>
 using namespace Simplex;
+uint MyRigidBody::m_uTierCount[CT_COUNT] = { 0, 0, 0, 0 };
+std::vector<MyRigidBody*> MyRigidBody::m_lSATPair;
+std::vector<uint> MyRigidBody::m_lSATIndex;
+std::vector<uint> MyRigidBody::m_lSATResult;
 //Allocation
 void MyRigidBody::Init(void)
 {
@@ -9,6 +15,7 @@ void MyRigidBody::Init(void)
 	m_bVisibleARBB = false;
 
 	m_fRadius = 0.0f;
+	m_fRadiusG = 0.0f;
 
 	m_v3ColorColliding = C_RED;
 	m_v3ColorNotColliding = C_WHITE;
@@ -24,6 +31,12 @@ void MyRigidBody::Init(void)
 	m_v3ARBBSize = ZERO_V3;
 
 	m_m4ToWorld = IDENTITY_M4;
+
+	m_v3CenterG = ZERO_V3;
+	m_v3AxisG[0] = AXIS_X;
+	m_v3AxisG[1] = AXIS_Y;
+	m_v3AxisG[2] = AXIS_Z;
+	m_v3HalfWidthG = ZERO_V3;
 }
 void MyRigidBody::Swap(MyRigidBody& a_pOther)
 {
@@ -33,6 +46,7 @@ void MyRigidBody::Swap(MyRigidBody& a_pOther)
 	std::swap(m_bVisibleARBB, a_pOther.m_bVisibleARBB);
 
 	std::swap(m_fRadius, a_pOther.m_fRadius);
+	std::swap(m_fRadiusG, a_pOther.m_fRadiusG);
 
 	std::swap(m_v3ColorColliding, a_pOther.m_v3ColorColliding);
 	std::swap(m_v3ColorNotColliding, a_pOther.m_v3ColorNotColliding);
@@ -49,6 +63,11 @@ void MyRigidBody::Swap(MyRigidBody& a_pOther)
 
 	std::swap(m_m4ToWorld, a_pOther.m_m4ToWorld);
 
+	std::swap(m_v3CenterG, a_pOther.m_v3CenterG);
+	for (uint i = 0; i < 3; ++i)
+		std::swap(m_v3AxisG[i], a_pOther.m_v3AxisG[i]);
+	std::swap(m_v3HalfWidthG, a_pOther.m_v3HalfWidthG);
+
 	std::swap(m_CollidingRBSet, a_pOther.m_CollidingRBSet);
 }
 void MyRigidBody::Release(void)
@@ -123,6 +142,21 @@ void MyRigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
 
 	//we calculate the distance between min and max vectors
 	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
+
+	//the Oriented Bounding Box in global space, so SAT does not need the matrix
+	m_v3CenterG = vector3(m_m4ToWorld * vector4(m_v3Center, 1.0f));
+	float fScale = 0.0f;
+	for (uint i = 0; i < 3; ++i)
+	{
+		vector3 v3Column = vector3(m_m4ToWorld[i]);
+		float fLength = glm::length(v3Column);
+		if (fLength > 0.0f)
+			m_v3AxisG[i] = v3Column / fLength;
+		m_v3HalfWidthG[i] = m_v3HalfWidth[i] * fLength;
+		fScale = std::max(fScale, fLength);
+	}
+	//the sphere grows with the largest scale of the matrix
+	m_fRadiusG = m_fRadius * fScale;
 }
 //The big 3
 MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
@@ -163,6 +197,11 @@ MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
 
 	//Get the distance between the center and either the min or the max
 	m_fRadius = glm::distance(m_v3Center, m_v3MinL);
+
+	//with model matrix being the identity, the global box is the local one
+	m_v3CenterG = m_v3Center;
+	m_v3HalfWidthG = m_v3HalfWidth;
+	m_fRadiusG = m_fRadius;
 }
 MyRigidBody::MyRigidBody(MyRigidBody const& a_pOther)
 {
@@ -173,6 +212,7 @@ MyRigidBody::MyRigidBody(MyRigidBody const& a_pOther)
 	m_bVisibleARBB = a_pOther.m_bVisibleARBB;
 
 	m_fRadius = a_pOther.m_fRadius;
+	m_fRadiusG = a_pOther.m_fRadiusG;
 
 	m_v3ColorColliding = a_pOther.m_v3ColorColliding;
 	m_v3ColorNotColliding = a_pOther.m_v3ColorNotColliding;
@@ -189,6 +229,11 @@ MyRigidBody::MyRigidBody(MyRigidBody const& a_pOther)
 
 	m_m4ToWorld = a_pOther.m_m4ToWorld;
 
+	m_v3CenterG = a_pOther.m_v3CenterG;
+	for (uint i = 0; i < 3; ++i)
+		m_v3AxisG[i] = a_pOther.m_v3AxisG[i];
+	m_v3HalfWidthG = a_pOther.m_v3HalfWidthG;
+
 	m_CollidingRBSet = a_pOther.m_CollidingRBSet;
 }
 MyRigidBody& MyRigidBody::operator=(MyRigidBody const& a_pOther)
@@ -226,15 +271,62 @@ void MyRigidBody::ClearCollidingList(void)
 }
 bool MyRigidBody::IsColliding(MyRigidBody* const a_pOther)
 {
-	//check if spheres are colliding as pre-test
-	bool bColliding = (glm::distance(GetCenterGlobal(), a_pOther->GetCenterGlobal()) < m_fRadius + a_pOther->m_fRadius);
-	
-	//if they are colliding check the SAT
-	if (bColliding)
+	eCollisionTier eTier = PreTest(a_pOther);
+	//only then look for an axis that separates the oriented boxes
+	if (eTier == CT_COLLIDING && SAT(a_pOther) != eSATResults::SAT_NONE)
+		eTier = CT_SAT;
+	return SettleCollision(a_pOther, eTier);
+}
+void MyRigidBody::CheckCollisions(MyRigidBody* const* a_pPairList, uint a_uPairCount, bool* a_pColliding)
+{
+	//the cheap tests settle most of the pairs one at a time, the rest are kept for SAT
+	m_lSATPair.clear();
+	m_lSATIndex.clear();
+	for (uint i = 0; i < a_uPairCount; ++i)
 	{
-		if(SAT(a_pOther) != eSATResults::SAT_NONE)
-			bColliding = false;// reset to false
+		MyRigidBody* pA = a_pPairList[2 * i];
+		MyRigidBody* pB = a_pPairList[2 * i + 1];
+		eCollisionTier eTier = pA->PreTest(pB);
+		if (eTier != CT_COLLIDING)
+		{
+			a_pColliding[i] = pA->SettleCollision(pB, eTier);
+			continue;
+		}
+		m_lSATPair.push_back(pA);
+		m_lSATPair.push_back(pB);
+		m_lSATIndex.push_back(i);
+	}
+
+	uint uSATCount = m_lSATIndex.size();
+	if (uSATCount == 0)
+		return;
+	m_lSATResult.resize(uSATCount);
+	SATBatch(m_lSATPair.data(), uSATCount, m_lSATResult.data());
+	for (uint i = 0; i < uSATCount; ++i)
+	{
+		eCollisionTier eTier = m_lSATResult[i] != eSATResults::SAT_NONE ? CT_SAT : CT_COLLIDING;
+		a_pColliding[m_lSATIndex[i]] = m_lSATPair[2 * i]->SettleCollision(m_lSATPair[2 * i + 1], eTier);
 	}
+}
+eCollisionTier MyRigidBody::PreTest(MyRigidBody* const a_pOther)
+{
+	//check if spheres are colliding as pre-test, a single dot product settles most of the pairs
+	vector3 v3Distance = a_pOther->m_v3CenterG - m_v3CenterG;
+	float fRadii = m_fRadiusG + a_pOther->m_fRadiusG;
+	if (glm::dot(v3Distance, v3Distance) > fRadii * fRadii)
+		return CT_SPHERE;
+	//if they are check the Axis Realigned Bounding Box
+	if (m_v3MaxG.x < a_pOther->m_v3MinG.x || m_v3MinG.x > a_pOther->m_v3MaxG.x ||
+		m_v3MaxG.y < a_pOther->m_v3MinG.y || m_v3MinG.y > a_pOther->m_v3MaxG.y ||
+		m_v3MaxG.z < a_pOther->m_v3MinG.z || m_v3MinG.z > a_pOther->m_v3MaxG.z)
+		return CT_ARBB;
+	return CT_COLLIDING;
+}
+bool MyRigidBody::SettleCollision(MyRigidBody* const a_pOther, eCollisionTier a_eTier)
+{
+	++m_uTierCount[a_eTier];
+
+	bool bColliding = a_eTier == CT_COLLIDING;
 
 	if (bColliding) //they are colliding
 	{
@@ -249,6 +341,19 @@ bool MyRigidBody::IsColliding(MyRigidBody* const a_pOther)
 
 	return bColliding;
 }
+uint MyRigidBody::GetTierCount(eCollisionTier a_eTier)
+{
+	if (a_eTier >= CT_COUNT)
+		return 0;
+	return m_uTierCount[a_eTier];
+}
+void MyRigidBody::ResetTierCount(void)
+{
+	for (uint i = 0; i < CT_COUNT; ++i)
+	{
+		m_uTierCount[i] = 0;
+	}
+}
 void MyRigidBody::AddToRenderList(void)
 {
 	if (m_bVisibleBS)
@@ -276,48 +381,34 @@ void MyRigidBody::AddToRenderList(void)
 
 uint MyRigidBody::SAT(MyRigidBody* const a_pOther)
 {
-	//Aggregate info for Creeper and Steve
-	//Locals
-	vector3 creepLocal[3] = { this->GetModelMatrix()[0], this->GetModelMatrix()[1], this->GetModelMatrix()[2] };
-	vector3 steveLocal[3] = { a_pOther->GetModelMatrix()[0], a_pOther->GetModelMatrix()[1], a_pOther->GetModelMatrix()[2] };
-
-	//Centers
-	vector3 creepCenter = this->GetCenterGlobal();
-	vector3 steveCenter = a_pOther->GetCenterGlobal();
-
-	//Half-width
-	vector3 creepHalf = this->GetHalfWidth();
-	vector3 steveHalf = a_pOther->GetHalfWidth();
+	//Aggregate info for Creeper and Steve, the global box was computed in SetModelMatrix
+	vector3* creepLocal = this->m_v3AxisG;
+	vector3* steveLocal = a_pOther->m_v3AxisG;
+	vector3 creepHalf = this->m_v3HalfWidthG;
+	vector3 steveHalf = a_pOther->m_v3HalfWidthG;
 
-	
 	//Variables for rotation matrix calculation
 	float creep, steve;
-	glm::mat3 rot, absRot;
+	float rot[3][3], absRot[3][3];
 
+	//Steve's axes in Creeper's frame, with the common subex. and the super-cool epsilon from <cfloat>
 	for (int i = 0; i < 3; i++) {
 		for (int j = 0; j < 3; j++) {
 			rot[i][j] = glm::dot(creepLocal[i], steveLocal[j]);
+			absRot[i][j] = abs(rot[i][j]) + FLT_EPSILON;
 		}
 	}
 
-	//Get translation vector
-	vector3 transVec = steveCenter - creepCenter;
-	//Transfer to coordinate frame
+	//Get translation vector and transfer it to Creeper's frame
+	vector3 transVec = a_pOther->m_v3CenterG - this->m_v3CenterG;
 	transVec = vector3(glm::dot(transVec, creepLocal[0]), glm::dot(transVec, creepLocal[1]), glm::dot(transVec, creepLocal[2]));
-	
-	//Calculate common subex. with super-cool epsilon from <cfloat>
-	for (int i = 0; i < 3; i++) {
-		for (int j = 0; j < 3; j++) {
-			absRot[i][j] = abs(rot[i][j]) + FLT_EPSILON;
-		}
-	}
 
 	//Test for AX/AY/AZ
 	for (int i = 0; i < 3; i++) {
 		creep = creepHalf[i];
-		steve = steveHalf[0] * absRot[i][0] + steveHalf[1] + absRot[i][1] + steveHalf[2] * absRot[i][2];
+		steve = steveHalf[0] * absRot[i][0] + steveHalf[1] * absRot[i][1] + steveHalf[2] * absRot[i][2];
 		if (abs(transVec[i]) > creep + steve) {
-			return 1;
+			return eSATResults::SAT_AX + i;
 		}
 	}
 
@@ -325,72 +416,223 @@ uint MyRigidBody::SAT(MyRigidBody* const a_pOther)
 	for (int i = 0; i < 3; i++) {
 		creep = creepHalf[0] * absRot[0][i] + creepHalf[1] * absRot[1][i] + creepHalf[2] * absRot[2][i];
 		steve = steveHalf[i];
-		if (abs(transVec[0] * rot[0][i] + transVec[1] * rot[1][i] + transVec[2] * rot[2][i] > creep + steve)) {
-			return 1;
+		if (abs(transVec[0] * rot[0][i] + transVec[1] * rot[1][i] + transVec[2] * rot[2][i]) > creep + steve) {
+			return eSATResults::SAT_BX + i;
 		}
 	}
 
-	//Test for AX/BX
-	creep = creepHalf[1] * absRot[2][0] + creepHalf[2] * absRot[1][0];
-	steve = steveHalf[1] * absRot[0][2] + steveHalf[2] * absRot[0][1];
-	if (abs(transVec[2] * rot[1][0] - transVec[1] * rot[2][0]) > creep + steve) {
-		return 1;
-	}
-	//Test for AX/BY
-	creep = creepHalf[1] * absRot[2][1] + creepHalf[2] * absRot[1][1];
-	steve = steveHalf[0] * absRot[0][2] + steveHalf[2] * absRot[0][0];
-	if (abs(transVec[2] * rot[1][1] - transVec[1] * rot[2][1]) > creep + steve) {
-		return 1;
-	}
-	//Test for AX/BZ
-	creep = creepHalf[1] * absRot[2][2] + creepHalf[2] * absRot[1][2];
-	steve = steveHalf[0] * absRot[0][1] + steveHalf[1] * absRot[0][0];
-	if (abs(transVec[2] * rot[1][2] - transVec[1] * rot[2][2]) > creep + steve) {
-		return 1;
+	//Test for the 9 cross products, AX/BX, AX/BY ... AZ/BZ
+	for (int i = 0; i < 3; i++) {
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; j++) {
+			int j1 = (j + 1) % 3;
+			int j2 = (j + 2) % 3;
+			creep = creepHalf[i1] * absRot[i2][j] + creepHalf[i2] * absRot[i1][j];
+			steve = steveHalf[j1] * absRot[i][j2] + steveHalf[j2] * absRot[i][j1];
+			if (abs(transVec[i2] * rot[i1][j] - transVec[i1] * rot[i2][j]) > creep + steve) {
+				return eSATResults::SAT_AXxBX + 3 * i + j;
+			}
+		}
 	}
 
+	//there is no axis test that separates this two objects
+	return eSATResults::SAT_NONE;
+}
 
-	//Test for AY/BX
-	creep = creepHalf[0] * absRot[2][0] + creepHalf[2] * absRot[0][0];
-	steve = steveHalf[1] * absRot[1][2] + steveHalf[2] * absRot[1][1];
-	if (abs(transVec[0] * rot[2][0] - transVec[2] * rot[0][0]) > creep + steve) {
-		return 1;
-	}
-	//Test for AY/BY
-	creep = creepHalf[0] * absRot[2][1] + creepHalf[2] * absRot[0][1];
-	steve = steveHalf[0] * absRot[1][2] + steveHalf[2] * absRot[1][0];
-	if (abs(transVec[0] * rot[2][1] - transVec[2] * rot[0][1]) > creep + steve) {
-		return 1;
-	}
-	//Test for AY/BZ
-	creep = creepHalf[0] * absRot[2][2] + creepHalf[2] * absRot[0][2];
-	steve = steveHalf[0] * absRot[1][1] + steveHalf[1] * absRot[1][0];
-	if (abs(transVec[0] * rot[2][2] - transVec[2] * rot[0][2]) > creep + steve) {
-		return 1;
-	}
+//SIMD lanes used by SATBatch, 8 pairs at a time with AVX and 4 with SSE
+namespace
+{
+#ifdef __AVX__
+	typedef __m256 Lanes;
+	const uint c_uLanes = 8;
+	inline Lanes LoadLanes(float const* a_pValue) { return _mm256_load_ps(a_pValue); }
+	inline void StoreLanes(float* a_pValue, Lanes a) { _mm256_store_ps(a_pValue, a); }
+	inline Lanes SetLanes(float a_fValue) { return _mm256_set1_ps(a_fValue); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+	inline Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+	inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+	inline Lanes AndNot(Lanes a, Lanes b) { return _mm256_andnot_ps(a, b); }
+	inline Lanes Or(Lanes a, Lanes b) { return _mm256_or_ps(a, b); }
+	inline Lanes Greater(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	inline Lanes Select(Lanes a, Lanes b, Lanes mask) { return _mm256_blendv_ps(a, b, mask); }
+	inline int Mask(Lanes a) { return _mm256_movemask_ps(a); }
+#else
+	typedef __m128 Lanes;
+	const uint c_uLanes = 4;
+	inline Lanes LoadLanes(float const* a_pValue) { return _mm_load_ps(a_pValue); }
+	inline void StoreLanes(float* a_pValue, Lanes a) { _mm_store_ps(a_pValue, a); }
+	inline Lanes SetLanes(float a_fValue) { return _mm_set1_ps(a_fValue); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	inline Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+	inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+	inline Lanes AndNot(Lanes a, Lanes b) { return _mm_andnot_ps(a, b); }
+	inline Lanes Or(Lanes a, Lanes b) { return _mm_or_ps(a, b); }
+	inline Lanes Greater(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+	inline Lanes Select(Lanes a, Lanes b, Lanes mask) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }
+	inline int Mask(Lanes a) { return _mm_movemask_ps(a); }
+#endif
+	inline Lanes Abs(Lanes a) { return AndNot(SetLanes(-0.0f), a); }
+	inline Lanes Dot(Lanes const* a, Lanes const* b) { return Add(Add(Mul(a[0], b[0]), Mul(a[1], b[1])), Mul(a[2], b[2])); }
+}
 
+void MyRigidBody::SATBatch(MyRigidBody* const* a_pPairList, uint a_uPairCount, uint* a_pResult)
+{
+	for (uint uFirst = 0; uFirst < a_uPairCount; uFirst += c_uLanes)
+	{
+		uint uCount = std::min(c_uLanes, a_uPairCount - uFirst);
+
+		//transpose the boxes of this batch so each value of every pair sits in one register,
+		//unused lanes stay at zero and can never be separated
+		alignas(32) float fAxisA[3][3][c_uLanes] = {};
+		alignas(32) float fAxisB[3][3][c_uLanes] = {};
+		alignas(32) float fHalfA[3][c_uLanes] = {};
+		alignas(32) float fHalfB[3][c_uLanes] = {};
+		alignas(32) float fTrans[3][c_uLanes] = {};
+		for (uint k = 0; k < uCount; ++k)
+		{
+			MyRigidBody* pA = a_pPairList[2 * (uFirst + k)];
+			MyRigidBody* pB = a_pPairList[2 * (uFirst + k) + 1];
+			vector3 v3Trans = pB->m_v3CenterG - pA->m_v3CenterG;
+			for (uint i = 0; i < 3; ++i)
+			{
+				for (uint c = 0; c < 3; ++c)
+				{
+					fAxisA[i][c][k] = pA->m_v3AxisG[i][c];
+					fAxisB[i][c][k] = pB->m_v3AxisG[i][c];
+				}
+				fHalfA[i][k] = pA->m_v3HalfWidthG[i];
+				fHalfB[i][k] = pB->m_v3HalfWidthG[i];
+				fTrans[i][k] = v3Trans[i];
+			}
+		}
 
-	//Test for AZ/BX
-	creep = creepHalf[0] * absRot[1][0] + creepHalf[1] * absRot[0][0];
-	steve = steveHalf[1] * absRot[2][2] + steveHalf[2] * absRot[2][1];
-	if (abs(transVec[1] * rot[0][0] - transVec[0] * rot[1][0]) > creep + steve) {
-		return 1;
-	}
-	//Test for AZ/BY
-	creep = creepHalf[0] * absRot[1][1] + creepHalf[1] * absRot[0][1];
-	steve = steveHalf[0] * absRot[2][2] + steveHalf[2] * absRot[2][0];
-	if (abs(transVec[1] * rot[0][1] - transVec[0] * rot[1][1]) > creep + steve) {
-		return 1;
-	}
-	//Test for AZ/BZ
-	creep = creepHalf[0] * absRot[1][2] + creepHalf[1] * absRot[0][2];
-	steve = steveHalf[0] * absRot[2][1] + steveHalf[1] * absRot[2][0];
-	if (abs(transVec[1] * rot[0][2] - transVec[0] * rot[1][2]) > creep + steve) {
-		return 1;
+		Lanes vAxisA[3][3], vAxisB[3][3], vHalfA[3], vHalfB[3], vTransG[3];
+		for (uint i = 0; i < 3; ++i)
+		{
+			for (uint c = 0; c < 3; ++c)
+			{
+				vAxisA[i][c] = LoadLanes(fAxisA[i][c]);
+				vAxisB[i][c] = LoadLanes(fAxisB[i][c]);
+			}
+			vHalfA[i] = LoadLanes(fHalfA[i]);
+			vHalfB[i] = LoadLanes(fHalfB[i]);
+			vTransG[i] = LoadLanes(fTrans[i]);
+		}
+
+		//same math as SAT, one pair per lane
+		Lanes vRot[3][3], vAbsRot[3][3], vTrans[3];
+		Lanes vEpsilon = SetLanes(FLT_EPSILON);
+		for (uint i = 0; i < 3; ++i)
+		{
+			for (uint j = 0; j < 3; ++j)
+			{
+				vRot[i][j] = Dot(vAxisA[i], vAxisB[j]);
+				vAbsRot[i][j] = Add(Abs(vRot[i][j]), vEpsilon);
+			}
+			vTrans[i] = Dot(vTransG, vAxisA[i]);
+		}
+
+		//lanes that already found a separating axis keep the first one they found
+		int nDone = ~((1 << uCount) - 1) & ((1 << c_uLanes) - 1);
+		int nAll = (1 << c_uLanes) - 1;
+		Lanes vSeparated = SetLanes(0.0f);
+		Lanes vResult = SetLanes(static_cast<float>(eSATResults::SAT_NONE));
+		uint uAxis = eSATResults::SAT_AX;
+		auto Test = [&](Lanes a_vDistance, Lanes a_vCreep, Lanes a_vSteve)
+		{
+			Lanes vNew = AndNot(vSeparated, Greater(Abs(a_vDistance), Add(a_vCreep, a_vSteve)));
+			vResult = Select(vResult, SetLanes(static_cast<float>(uAxis)), vNew);
+			vSeparated = Or(vSeparated, vNew);
+			++uAxis;
+			return ((Mask(vSeparated) | nDone) == nAll);
+		};
+
+		bool bDone = false;
+		//Test for AX/AY/AZ
+		for (uint i = 0; i < 3 && !bDone; ++i)
+		{
+			Lanes vSteve = Add(Add(Mul(vHalfB[0], vAbsRot[i][0]), Mul(vHalfB[1], vAbsRot[i][1])), Mul(vHalfB[2], vAbsRot[i][2]));
+			bDone = Test(vTrans[i], vHalfA[i], vSteve);
+		}
+		//Test for BX/BY/BZ
+		for (uint i = 0; i < 3 && !bDone; ++i)
+		{
+			Lanes vCreep = Add(Add(Mul(vHalfA[0], vAbsRot[0][i]), Mul(vHalfA[1], vAbsRot[1][i])), Mul(vHalfA[2], vAbsRot[2][i]));
+			Lanes vDistance = Add(Add(Mul(vTrans[0], vRot[0][i]), Mul(vTrans[1], vRot[1][i])), Mul(vTrans[2], vRot[2][i]));
+			bDone = Test(vDistance, vCreep, vHalfB[i]);
+		}
+		//Test for the 9 cross products
+		for (uint i = 0; i < 3 && !bDone; ++i)
+		{
+			uint i1 = (i + 1) % 3;
+			uint i2 = (i + 2) % 3;
+			for (uint j = 0; j < 3 && !bDone; ++j)
+			{
+				uint j1 = (j + 1) % 3;
+				uint j2 = (j + 2) % 3;
+				Lanes vCreep = Add(Mul(vHalfA[i1], vAbsRot[i2][j]), Mul(vHalfA[i2], vAbsRot[i1][j]));
+				Lanes vSteve = Add(Mul(vHalfB[j1], vAbsRot[i][j2]), Mul(vHalfB[j2], vAbsRot[i][j1]));
+				Lanes vDistance = Sub(Mul(vTrans[i2], vRot[i1][j]), Mul(vTrans[i1], vRot[i2][j]));
+				bDone = Test(vDistance, vCreep, vSteve);
+			}
+		}
+
+		alignas(32) float fResult[c_uLanes];
+		StoreLanes(fResult, vResult);
+		for (uint k = 0; k < uCount; ++k)
+		{
+			a_pResult[uFirst + k] = static_cast<uint>(fResult[k]);
+		}
 	}
+}
+bool MyRigidBody::CheckSATBatch(uint a_uRounds)
+{
+	//scaled cubes placed close enough together that a good share of the pairs collide
+	std::vector<vector3> lPoint = { vector3(-0.5f), vector3(0.5f) };
+	const uint uBodyCount = 16;
+	std::vector<MyRigidBody*> lBody;
+	for (uint i = 0; i < uBodyCount; ++i)
+		lBody.push_back(new MyRigidBody(lPoint));
+
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	auto Random = [&](void) { return distribution(generator); };
+
+	bool bMatch = true;
+	MyRigidBody* pPairList[16];
+	uint uResult[8];
+	for (uint uRound = 0; uRound < a_uRounds && bMatch; ++uRound)
+	{
+		for (uint i = 0; i < uBodyCount; ++i)
+		{
+			vector3 v3Axis = vector3(Random(), Random(), Random());
+			if (glm::length(v3Axis) < 0.1f)
+				v3Axis = AXIS_Y;
+			vector3 v3Scale = vector3(1.25f + Random() * 0.75f, 1.25f + Random() * 0.75f, 1.25f + Random() * 0.75f);
+			lBody[i]->SetModelMatrix(glm::translate(vector3(Random(), Random(), Random()) * 2.0f) *
+				glm::rotate(IDENTITY_M4, Random() * static_cast<float>(PI), glm::normalize(v3Axis)) * glm::scale(v3Scale));
+		}
 
-	//kaput
+		for (uint uCount = 1; uCount <= 8 && bMatch; ++uCount)
+		{
+			for (uint i = 0; i < uCount; ++i)
+			{
+				pPairList[2 * i] = lBody[(uRound + 2 * i) % uBodyCount];
+				pPairList[2 * i + 1] = lBody[(uRound + 2 * i + 1 + uCount) % uBodyCount];
+			}
+			SATBatch(pPairList, uCount, uResult);
+			for (uint i = 0; i < uCount; ++i)
+			{
+				if (uResult[i] != pPairList[2 * i]->SAT(pPairList[2 * i + 1]))
+					bMatch = false;
+			}
+		}
+	}
 
-	//there is no axis test that separates this two objects
-	return eSATResults::SAT_NONE;
-}
\ No newline at end of file
+	for (uint i = 0; i < uBodyCount; ++i)
+		SafeDelete(lBody[i]);
+	return bMatch;
+}
@@ -10,6 +10,16 @@ Date: 2017/06
 namespace Simplex
 {
 
+//Stage of the collision test that settled a pair, IsColliding and CheckCollisions count the pairs settled by each
+enum eCollisionTier
+{
+	CT_SPHERE = 0, //rejected by the bounding spheres
+	CT_ARBB, //rejected by the axis (re)aligned bounding boxes
+	CT_SAT, //rejected by the separating axis test of the oriented bounding boxes
+	CT_COLLIDING, //passed every test
+	CT_COUNT //number of tiers
+};
+
 //System Class
 class MyRigidBody
 {
@@ -20,6 +30,7 @@ class MyRigidBody
 	bool m_bVisibleARBB = true; //Visibility of axis (Re)aligned bounding box
 
 	float m_fRadius = 0.0f; //Radius
+	float m_fRadiusG = 0.0f; //Radius in global space (scaled by the model matrix)
 
 	vector3 m_v3ColorColliding = C_RED; //Color when colliding
 	vector3 m_v3ColorNotColliding = C_WHITE; //Color when not colliding
@@ -36,8 +47,17 @@ class MyRigidBody
 
 	matrix4 m_m4ToWorld = IDENTITY_M4; //Matrix that will take us from local to world coordinate
 
+	vector3 m_v3CenterG = ZERO_V3; //center of the Oriented Bounding Box in global space
+	vector3 m_v3AxisG[3] = { AXIS_X, AXIS_Y, AXIS_Z }; //unit axes of the Oriented Bounding Box in global space
+	vector3 m_v3HalfWidthG = ZERO_V3; //half the size of the Oriented Bounding Box along its global axes (scaled)
+
 	std::set<MyRigidBody*> m_CollidingRBSet; //set of rigid bodies this one is colliding with
 
+	static uint m_uTierCount[CT_COUNT]; //pairs settled by each tier of IsColliding and CheckCollisions since the last reset
+	static std::vector<MyRigidBody*> m_lSATPair; //pairs CheckCollisions hands to SATBatch, two bodies per pair
+	static std::vector<uint> m_lSATIndex; //index in the list of CheckCollisions of each pair handed to SATBatch
+	static std::vector<uint> m_lSATResult; //result of SATBatch for each pair handed to it
+
 public:
 	/*
 	Usage: Constructor
@@ -104,6 +124,48 @@ public:
 	OUTPUT: are they colliding?
 	*/
 	bool IsColliding(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Gets how many pairs the specified tier of IsColliding settled since the last reset
+	ARGUMENTS: eCollisionTier a_eTier -> queried tier
+	OUTPUT: pair count
+	*/
+	static uint GetTierCount(eCollisionTier a_eTier);
+	/*
+	USAGE: Sets the pair count of every tier back to zero
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	static void ResetTierCount(void);
+
+	/*
+	USAGE: Runs the Separation Axis Test on many pairs at once, several pairs per SIMD
+		instruction, using the global axes and half widths each body computed when its
+		model matrix was set
+	ARGUMENTS:
+	-	MyRigidBody* const* a_pPairList -> bodies to test, two per pair
+	-	uint a_uPairCount -> number of pairs
+	-	uint* a_pResult -> filled with the result of each pair, 0 for colliding, other =
+		first axis that separates them (same as SAT)
+	OUTPUT: ---
+	*/
+	static void SATBatch(MyRigidBody* const* a_pPairList, uint a_uPairCount, uint* a_pResult);
+	/*
+	USAGE: Tells which of the pairs are colliding, same tiers as IsColliding but the pairs
+		that get past the spheres and the boxes go through SATBatch together
+	ARGUMENTS:
+	-	MyRigidBody* const* a_pPairList -> bodies to test, two per pair
+	-	uint a_uPairCount -> number of pairs
+	-	bool* a_pColliding -> filled with whether each pair is colliding
+	OUTPUT: ---
+	*/
+	static void CheckCollisions(MyRigidBody* const* a_pPairList, uint a_uPairCount, bool* a_pColliding);
+	/*
+	USAGE: Runs SATBatch and SAT on random pairs and compares them, with batches of every
+		size from 1 to 8 pairs so full, partial and several SIMD batches are all covered
+	ARGUMENTS: uint a_uRounds = 64 -> random batches of each size
+	OUTPUT: did both give the same result for every pair?
+	*/
+	static bool CheckSATBatch(uint a_uRounds = 64);
 #pragma region Accessors
 	/*
 	Usage: Gets visibility of bounding sphere
@@ -247,6 +309,22 @@ private:
 	OUTPUT: 0 for colliding, other = first axis that succeeds test
 	*/
 	uint SAT(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Runs the tests that come before SAT, the bounding spheres and then the axis
+		(re)aligned bounding boxes
+	ARGUMENTS: MyRigidBody* const a_pOther -> other rigid body to test against
+	OUTPUT: tier that rejected the pair, CT_COLLIDING if it still has to go through SAT
+	*/
+	eCollisionTier PreTest(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Counts the pair for the tier that settled it and adds or removes each body from
+		the colliding list of the other
+	ARGUMENTS:
+	-	MyRigidBody* const a_pOther -> other rigid body of the pair
+	-	eCollisionTier a_eTier -> tier that settled the pair
+	OUTPUT: are they colliding?
+	*/
+	bool SettleCollision(MyRigidBody* const a_pOther, eCollisionTier a_eTier);
 };//class
 
 } //namespace Simplex
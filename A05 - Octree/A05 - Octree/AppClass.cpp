@@ -18,20 +18,23 @@ void Application::InitVariables(void)
 #endif
 	int nSquare = static_cast<int>(std::sqrt(uInstances));
 	m_uObjects = nSquare * nSquare;
-	uint uIndex = -1;
-	for (int i = 0; i < nSquare; i++)
+	//create all of them in one go
+	std::vector<MyEntityRecord> lRecord(m_uObjects);
+	for (uint uIndex = 0; uIndex < m_uObjects; uIndex++)
 	{
-		for (int j = 0; j < nSquare; j++)
-		{
-			uIndex++;
-			m_pEntityMngr->AddEntity("Minecraft\\Cube.obj");
-			vector3 v3Position = vector3(glm::sphericalRand(34.0f));
-			matrix4 m4Position = glm::translate(v3Position);
-			m_pEntityMngr->SetModelMatrix(m4Position);
-		}
+		vector3 v3Position = vector3(glm::sphericalRand(34.0f));
+		lRecord[uIndex].m_sFileName = "Minecraft\\Cube.obj";
+		lRecord[uIndex].m_m4ToWorld = glm::translate(v3Position);
 	}
+	m_pEntityMngr->AddEntities(lRecord);
 	m_uOctantLevels = 1;
+	m_pLinearRoot = new MyLinearOctree(m_uOctantLevels, 5);
+	m_pEntityMngr->SetLinearOctree(m_pLinearRoot);
+	m_pLooseRoot = new MyLooseOctree(m_uOctantLevels);
+	m_pEntityMngr->SetLooseOctree(m_pLooseRoot);
 	m_pRoot = new MyOctant(m_uOctantLevels, 5);
+	m_pEntityMngr->SetOctree(m_pRoot);
+	m_pEntityMngr->SetBroadPhase(BP_OCTREE);
 	m_pEntityMngr->Update();
 }
 void Application::Update(void)
@@ -44,8 +47,13 @@ void Application::Update(void)
 
 	//Is the first person camera active?
 	CameraRotation();
+
+	//the linear octree is cheap to rebuild, so it is built from scratch every frame
+	if (m_pEntityMngr->GetBroadPhase() == BP_LINEAR_OCTREE)
+		m_pLinearRoot->ConstructTree(m_uOctantLevels);
 	
-	//Update Entity Manager
+	//Update Entity Manager, counting the pairs each collision tier settles this frame
+	MyRigidBody::ResetTierCount();
 	m_pEntityMngr->Update();
 
 	//Add objects to render list
@@ -57,7 +65,30 @@ void Application::Display(void)
 	ClearScreen();
 
 	//display octree
-	if (m_uOctantID == -1)
+	if (m_pEntityMngr->GetBroadPhase() == BP_LINEAR_OCTREE)
+	{
+		if (m_uOctantID == -1)
+			m_pLinearRoot->DisplayLeafs();
+		else
+			m_pLinearRoot->Display(m_uOctantID);
+	}
+	else if (m_pEntityMngr->GetBroadPhase() == BP_SWEEP_AND_PRUNE || m_pEntityMngr->GetBroadPhase() == BP_SPATIAL_HASH)
+	{
+		//no tree to show
+	}
+	else if (m_pEntityMngr->GetBroadPhase() == BP_LOOSE_OCTREE)
+	{
+		if (m_uOctantID == -1)
+			m_pLooseRoot->Display();
+		else
+			m_pLooseRoot->Display(m_uOctantID);
+	}
+	else if (m_pEntityMngr->GetBroadPhase() == BP_DYNAMIC_TREE)
+	{
+		//the octant index picks how deep the hierarchy is shown
+		m_pEntityMngr->GetDynamicTree()->Display(m_uOctantID);
+	}
+	else if (m_uOctantID == -1)
 	{
 		m_pRoot->Display();
 	}
@@ -81,10 +112,54 @@ void Application::Display(void)
 	//end the current frame (internally swaps the front and back buffers)
 	m_pWindow->display();
 }
+void Application::BenchmarkBroadPhases(void)
+{
+	//switching the broad phase forgets the cached pairs, so every run tests the whole scene
+	const uint uRuns = 5;
+	eBroadPhase ePhase = m_pEntityMngr->GetBroadPhase();
+	uint uClock = m_pSystem->GenClock();
+
+	m_fHashTime = 0.0f;
+	for (uint uRun = 0; uRun < uRuns; ++uRun)
+	{
+		m_pEntityMngr->SetBroadPhase(BP_SPATIAL_HASH);
+		m_pSystem->GetDeltaTime(uClock);
+		m_pEntityMngr->Update();
+		m_fHashTime += m_pSystem->GetDeltaTime(uClock) * 1000.0f / uRuns;
+	}
+
+	m_lOctreeTime.clear();
+	m_lOctreeBuildTime.clear();
+	for (uint uLevel = 0; uLevel <= 4; ++uLevel)
+	{
+		m_pSystem->GetDeltaTime(uClock);
+		m_pRoot->ConstructTree(uLevel);
+		m_lOctreeBuildTime.push_back(m_pSystem->GetDeltaTime(uClock) * 1000.0f);
+		float fTime = 0.0f;
+		for (uint uRun = 0; uRun < uRuns; ++uRun)
+		{
+			m_pEntityMngr->SetBroadPhase(BP_OCTREE);
+			m_pSystem->GetDeltaTime(uClock);
+			m_pEntityMngr->Update();
+			fTime += m_pSystem->GetDeltaTime(uClock) * 1000.0f / uRuns;
+		}
+		m_lOctreeTime.push_back(fTime);
+	}
+
+	//nothing moved, only the octree has to go back to its own level
+	m_pRoot->ConstructTree(m_uOctantLevels);
+	m_pEntityMngr->SetBroadPhase(ePhase);
+}
 void Application::Release(void)
 {
 	//obliteration
+	m_pEntityMngr->SetOctree(nullptr);
 	SafeDelete(m_pRoot);
+	m_pEntityMngr->SetLinearOctree(nullptr);
+	SafeDelete(m_pLinearRoot);
+	m_pEntityMngr->SetLooseOctree(nullptr);
+	SafeDelete(m_pLooseRoot);
+	MyThreadPool::ReleaseInstance();
 
 	//release GUI
 	ShutdownGUI();
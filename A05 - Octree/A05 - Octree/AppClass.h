@@ -13,6 +13,9 @@ Date: 2017/06
 #include "MyEntityManager.h"
 
 #include "MyOctant.h"
+#include "MyLinearOctree.h"
+#include "MyLooseOctree.h"
+#include "MyThreadPool.h"
 
 namespace Simplex
 {
@@ -20,10 +23,15 @@ namespace Simplex
 class Application
 {
 	MyOctant* m_pRoot = nullptr;
+	MyLinearOctree* m_pLinearRoot = nullptr; //Morton code octree, rebuilt every frame while in use
+	MyLooseOctree* m_pLooseRoot = nullptr; //Loose octree, each entity lives in a single octant
 	MyEntityManager* m_pEntityMngr = nullptr; //Entity Manager
 	uint m_uOctantID = -1; //Index of Octant to display
 	uint m_uObjects = 0; //Number of objects in the scene
 	uint m_uOctantLevels = 0; //Number of levels in the octree
+	float m_fHashTime = -1.0f; //ms per update of the spatial hash in the last benchmark, negative if none ran
+	std::vector<float> m_lOctreeTime; //ms per update of the octree at each level in the last benchmark
+	std::vector<float> m_lOctreeBuildTime; //ms to build the octree at each level in the last benchmark
 private:
 	String m_sProgrammer = "Matthew Camera - mjc9536@rit.edu"; //programmer
 
@@ -161,6 +169,13 @@ private:
 	*/
 	void ClearScreen(vector4 a_v4ClearColor = vector4(-1.0f));
 	/*
+	USAGE: Times the spatial hash and the octree at every level over the current scene, each
+	update tests every pair again, then puts the broad phase back as it was
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void BenchmarkBroadPhases(void);
+	/*
 	USAGE: Will initialize the controllers generically
 	ARGUMENTS:
 	OUTPUT: ---
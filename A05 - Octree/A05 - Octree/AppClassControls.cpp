@@ -1,4 +1,5 @@
 #include "AppClass.h"
+#include <cassert>
 using namespace Simplex;
 //Mouse
 void Application::ProcessMouseMovement(sf::Event a_event)
@@ -124,6 +125,47 @@ void Application::ProcessKeyReleased(sf::Event a_event)
 		if (m_uOctantID >= m_pRoot->GetOctantCount())
 			m_uOctantID = - 1;
 		
+		break;
+	case sf::Keyboard::B:
+		//cycle between testing every pair, by octree leaf, by linear octree leaf, by sweep, by loose octant,
+		//by dynamic tree and by hashed cell
+		switch (m_pEntityMngr->GetBroadPhase())
+		{
+		case BP_NONE:
+			//the entity manager rebuilds the octree when switching to it
+			m_pEntityMngr->SetBroadPhase(BP_OCTREE);
+			break;
+		case BP_OCTREE:
+			m_pEntityMngr->SetBroadPhase(BP_LINEAR_OCTREE);
+			break;
+		case BP_LINEAR_OCTREE:
+			m_pEntityMngr->SetBroadPhase(BP_SWEEP_AND_PRUNE);
+			break;
+		case BP_SWEEP_AND_PRUNE:
+			//the moves were not followed while in another phase
+			m_pLooseRoot->ConstructTree(m_uOctantLevels);
+			m_pEntityMngr->SetBroadPhase(BP_LOOSE_OCTREE);
+			break;
+		case BP_LOOSE_OCTREE:
+			//the entity manager rebuilds its own tree when switching to it
+			m_pEntityMngr->SetBroadPhase(BP_DYNAMIC_TREE);
+			break;
+		case BP_DYNAMIC_TREE:
+			m_pEntityMngr->SetBroadPhase(BP_SPATIAL_HASH);
+			break;
+		default:
+			m_pEntityMngr->SetBroadPhase(BP_NONE);
+			break;
+		}
+		break;
+	case sf::Keyboard::T:
+		BenchmarkBroadPhases();
+		break;
+	case sf::Keyboard::P:
+		//check the octree leafs and build the octree on one thread or on all of them
+		m_pEntityMngr->SetParallel(!m_pEntityMngr->GetParallel());
+		MyOctant::SetParallelBuild(m_pEntityMngr->GetParallel());
+		assert(m_pRoot->CheckParallelBuild());
 		break;
 	case sf::Keyboard::Add:
 		if (m_uOctantLevels < 4)
@@ -131,8 +173,10 @@ void Application::ProcessKeyReleased(sf::Event a_event)
 			m_pEntityMngr->ClearDimensionSetAll();
 			++m_uOctantLevels;
 			
-			SafeDelete(m_pRoot);
-			m_pRoot = new MyOctant(m_uOctantLevels, 5);
+			m_pRoot->ConstructTree(m_uOctantLevels);
+			m_pEntityMngr->SetOctree(m_pRoot);
+			m_pLooseRoot->ConstructTree(m_uOctantLevels);
+			m_pEntityMngr->SetLooseOctree(m_pLooseRoot);
 			
 		}
 		break;
@@ -142,8 +186,10 @@ void Application::ProcessKeyReleased(sf::Event a_event)
 			m_pEntityMngr->ClearDimensionSetAll();
 			--m_uOctantLevels;
 			
-			SafeDelete(m_pRoot);
-			m_pRoot = new MyOctant(m_uOctantLevels, 5);
+			m_pRoot->ConstructTree(m_uOctantLevels);
+			m_pEntityMngr->SetOctree(m_pRoot);
+			m_pLooseRoot->ConstructTree(m_uOctantLevels);
+			m_pEntityMngr->SetLooseOctree(m_pLooseRoot);
 			
 		}
 		break;
@@ -41,6 +41,17 @@ void Application::DrawGUI(void)
 			ImGui::Text("Levels in Octree: %d\n", m_uOctantLevels);
 			ImGui::Text("Octants: %d\n", m_pRoot->GetOctantCount());
 			ImGui::Text("Objects: %d\n", m_uObjects);
+			ImGui::Text("Broad Phase: %s\n", m_pEntityMngr->GetBroadPhaseName().c_str());
+			ImGui::Text("Relocated in Loose Octree: %u\n", m_pLooseRoot->GetRelocatedCount());
+			ImGui::Text("Dynamic Tree Height: %u\n", m_pEntityMngr->GetDynamicTree()->GetHeight());
+			ImGui::Text("Hash Cells: %u (size %.2f)\n", m_pEntityMngr->GetSpatialHash()->GetCellCount(), m_pEntityMngr->GetSpatialHash()->GetCellSize());
+			ImGui::Text("Parallel Leafs and Build: %s\n", m_pEntityMngr->GetParallel() ? "On" : "Off");
+			ImGui::Text("Rejected by Sphere: %u\n", MyRigidBody::GetTierCount(CT_SPHERE));
+			ImGui::Text("Rejected by ARBB: %u\n", MyRigidBody::GetTierCount(CT_ARBB));
+			ImGui::Text("Rejected by SAT: %u\n", MyRigidBody::GetTierCount(CT_SAT));
+			ImGui::Text("Colliding: %u\n", MyRigidBody::GetTierCount(CT_COLLIDING));
+			ImGui::Text("Contacts: %u (+%u, -%u)\n", static_cast<uint>(m_pEntityMngr->GetContactList().size()),
+				static_cast<uint>(m_pEntityMngr->GetContactBegin().size()), static_cast<uint>(m_pEntityMngr->GetContactEnd().size()));
 			ImGui::Separator();
 			ImGui::Text("Control:\n");
 			ImGui::Text("   WASD: Movement\n");
@@ -54,6 +65,16 @@ void Application::DrawGUI(void)
 			ImGui::Separator();
 			ImGui::Text("	  -: Increment Octree subdivision\n");
 			ImGui::Text("	  +: Decrement Octree subdivision\n");
+			ImGui::Text("	  B: Cycle Broad Phase\n");
+			ImGui::Text("	  P: Toggle Parallel Leafs and Build\n");
+			ImGui::Text("	  T: Time Spatial Hash and Octree\n");
+			if (m_fHashTime >= 0.0f)
+			{
+				ImGui::Separator();
+				ImGui::Text("Spatial Hash: %.2f [ms/update]\n", m_fHashTime);
+				for (uint i = 0; i < m_lOctreeTime.size(); ++i)
+					ImGui::Text("Octree %u: %.2f [ms/update] + %.2f [ms/build]\n", i, m_lOctreeTime[i], m_lOctreeBuildTime[i]);
+			}
 			ImGui::Separator();
 			ImGui::TextColored(ImColor(255, 255, 0), "Octree\n");
 		}
@@ -0,0 +1,146 @@
+#include "MyAABBStore.h"
+#include <immintrin.h>
+using namespace Simplex;
+//  MyAABBStore
+uint Simplex::MyAABBStore::GetCount(void) { return m_uCount; }
+uint Simplex::MyAABBStore::GetVersion(void) { return m_uVersion; }
+void Simplex::MyAABBStore::Clear(void)
+{
+	++m_uVersion;
+	m_uCount = 0;
+	m_lMinX.clear();
+	m_lMinY.clear();
+	m_lMinZ.clear();
+	m_lMaxX.clear();
+	m_lMaxY.clear();
+	m_lMaxZ.clear();
+}
+void Simplex::MyAABBStore::Add(vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	++m_uCount;
+	uint uSize = m_uCount + m_uBatch;
+	m_lMinX.resize(uSize, 0.0f);
+	m_lMinY.resize(uSize, 0.0f);
+	m_lMinZ.resize(uSize, 0.0f);
+	m_lMaxX.resize(uSize, 0.0f);
+	m_lMaxY.resize(uSize, 0.0f);
+	m_lMaxZ.resize(uSize, 0.0f);
+	Set(m_uCount - 1, a_v3Min, a_v3Max);
+}
+void Simplex::MyAABBStore::Set(uint a_uIndex, vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	if (a_uIndex >= m_uCount)
+		return;
+	//adding and removing go through here too
+	++m_uVersion;
+	m_lMinX[a_uIndex] = a_v3Min.x;
+	m_lMinY[a_uIndex] = a_v3Min.y;
+	m_lMinZ[a_uIndex] = a_v3Min.z;
+	m_lMaxX[a_uIndex] = a_v3Max.x;
+	m_lMaxY[a_uIndex] = a_v3Max.y;
+	m_lMaxZ[a_uIndex] = a_v3Max.z;
+}
+void Simplex::MyAABBStore::Remove(uint a_uIndex)
+{
+	if (a_uIndex >= m_uCount)
+		return;
+	//same swap with the last one the Entity Manager does
+	uint uLast = m_uCount - 1;
+	Set(a_uIndex, GetMin(uLast), GetMax(uLast));
+	--m_uCount;
+	uint uSize = m_uCount + m_uBatch;
+	m_lMinX.resize(uSize);
+	m_lMinY.resize(uSize);
+	m_lMinZ.resize(uSize);
+	m_lMaxX.resize(uSize);
+	m_lMaxY.resize(uSize);
+	m_lMaxZ.resize(uSize);
+}
+vector3 Simplex::MyAABBStore::GetMin(uint a_uIndex)
+{
+	if (a_uIndex >= m_uCount)
+		return ZERO_V3;
+	return vector3(m_lMinX[a_uIndex], m_lMinY[a_uIndex], m_lMinZ[a_uIndex]);
+}
+vector3 Simplex::MyAABBStore::GetMax(uint a_uIndex)
+{
+	if (a_uIndex >= m_uCount)
+		return ZERO_V3;
+	return vector3(m_lMaxX[a_uIndex], m_lMaxY[a_uIndex], m_lMaxZ[a_uIndex]);
+}
+uint Simplex::MyAABBStore::OverlapMask(vector3 const& a_v3Min, vector3 const& a_v3Max, uint a_uFirst, uint a_uCount)
+{
+	if (a_uFirst >= m_uCount)
+		return 0;
+	if (a_uCount > m_uBatch)
+		a_uCount = m_uBatch;
+	if (a_uCount > m_uCount - a_uFirst)
+		a_uCount = m_uCount - a_uFirst;
+
+	//the padding at the end of the arrays makes the full batch load safe
+	uint uMask = OverlapBatch(a_v3Min, a_v3Max,
+		&m_lMinX[a_uFirst], &m_lMinY[a_uFirst], &m_lMinZ[a_uFirst],
+		&m_lMaxX[a_uFirst], &m_lMaxY[a_uFirst], &m_lMaxZ[a_uFirst]);
+	return uMask & ((1u << a_uCount) - 1);
+}
+uint Simplex::MyAABBStore::OverlapMask(vector3 const& a_v3Min, vector3 const& a_v3Max, uint const* a_pIndex, uint a_uCount)
+{
+	if (a_uCount > m_uBatch)
+		a_uCount = m_uBatch;
+
+	//gather the boxes into a batch, unused lanes are masked off below
+	alignas(32) float fBox[6][m_uBatch] = {};
+	uint uValid = 0;
+	for (uint k = 0; k < a_uCount; ++k)
+	{
+		uint uIndex = a_pIndex[k];
+		if (uIndex >= m_uCount)
+			continue;
+		uValid |= 1u << k;
+		fBox[0][k] = m_lMinX[uIndex];
+		fBox[1][k] = m_lMinY[uIndex];
+		fBox[2][k] = m_lMinZ[uIndex];
+		fBox[3][k] = m_lMaxX[uIndex];
+		fBox[4][k] = m_lMaxY[uIndex];
+		fBox[5][k] = m_lMaxZ[uIndex];
+	}
+	return OverlapBatch(a_v3Min, a_v3Max, fBox[0], fBox[1], fBox[2], fBox[3], fBox[4], fBox[5]) & uValid;
+}
+uint Simplex::MyAABBStore::OverlapBatch(vector3 const& a_v3Min, vector3 const& a_v3Max,
+	float const* a_pMinX, float const* a_pMinY, float const* a_pMinZ,
+	float const* a_pMaxX, float const* a_pMaxY, float const* a_pMaxZ)
+{
+	//same test as MyRigidBody::IsColliding: they overlap unless one is past the other on an axis
+#ifdef __AVX__
+	__m256 vOverlap = _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Max.x), _mm256_loadu_ps(a_pMinX), _CMP_GE_OQ),
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Min.x), _mm256_loadu_ps(a_pMaxX), _CMP_LE_OQ));
+	vOverlap = _mm256_and_ps(vOverlap, _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Max.y), _mm256_loadu_ps(a_pMinY), _CMP_GE_OQ),
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Min.y), _mm256_loadu_ps(a_pMaxY), _CMP_LE_OQ)));
+	vOverlap = _mm256_and_ps(vOverlap, _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Max.z), _mm256_loadu_ps(a_pMinZ), _CMP_GE_OQ),
+		_mm256_cmp_ps(_mm256_set1_ps(a_v3Min.z), _mm256_loadu_ps(a_pMaxZ), _CMP_LE_OQ)));
+	return static_cast<uint>(_mm256_movemask_ps(vOverlap));
+#else
+	//SSE, two halves of 4
+	__m128 vMaxX = _mm_set1_ps(a_v3Max.x), vMinX = _mm_set1_ps(a_v3Min.x);
+	__m128 vMaxY = _mm_set1_ps(a_v3Max.y), vMinY = _mm_set1_ps(a_v3Min.y);
+	__m128 vMaxZ = _mm_set1_ps(a_v3Max.z), vMinZ = _mm_set1_ps(a_v3Min.z);
+	uint uMask = 0;
+	for (uint uHalf = 0; uHalf < m_uBatch; uHalf += 4)
+	{
+		__m128 vOverlap = _mm_and_ps(
+			_mm_cmpge_ps(vMaxX, _mm_loadu_ps(a_pMinX + uHalf)),
+			_mm_cmple_ps(vMinX, _mm_loadu_ps(a_pMaxX + uHalf)));
+		vOverlap = _mm_and_ps(vOverlap, _mm_and_ps(
+			_mm_cmpge_ps(vMaxY, _mm_loadu_ps(a_pMinY + uHalf)),
+			_mm_cmple_ps(vMinY, _mm_loadu_ps(a_pMaxY + uHalf))));
+		vOverlap = _mm_and_ps(vOverlap, _mm_and_ps(
+			_mm_cmpge_ps(vMaxZ, _mm_loadu_ps(a_pMinZ + uHalf)),
+			_mm_cmple_ps(vMinZ, _mm_loadu_ps(a_pMaxZ + uHalf))));
+		uMask |= static_cast<uint>(_mm_movemask_ps(vOverlap)) << uHalf;
+	}
+	return uMask;
+#endif
+}
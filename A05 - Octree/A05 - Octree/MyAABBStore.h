@@ -0,0 +1,119 @@
+/*----------------------------------------------
+Programmer: Alberto Bobadilla (labigm@gmail.com)
+Date: 2017/07
+----------------------------------------------*/
+#ifndef __MYAABBSTORE_H_
+#define __MYAABBSTORE_H_
+
+#include "Simplex\Simplex.h"
+
+namespace Simplex
+{
+
+//Global axis aligned boxes kept as a struct of arrays so they can be tested in batches
+class MyAABBStore
+{
+	uint m_uCount = 0; //number of boxes
+	uint m_uVersion = 0; //changes whenever a box is set, added or removed
+	//each array holds m_uCount boxes plus a batch of padding so a batch can always be loaded
+	std::vector<float> m_lMinX;
+	std::vector<float> m_lMinY;
+	std::vector<float> m_lMinZ;
+	std::vector<float> m_lMaxX;
+	std::vector<float> m_lMaxY;
+	std::vector<float> m_lMaxZ;
+public:
+	static const uint m_uBatch = 8; //max boxes tested per OverlapMask call
+	/*
+	USAGE: Gets the number of boxes stored
+	ARGUMENTS: ---
+	OUTPUT: box count
+	*/
+	uint GetCount(void);
+	/*
+	USAGE: Gets a number that changes whenever a box is set, added or removed, so whoever
+	keeps something built from the boxes can tell whether it is still current
+	ARGUMENTS: ---
+	OUTPUT: version of the boxes
+	*/
+	uint GetVersion(void);
+	/*
+	USAGE: Removes every box, the memory is kept
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Clear(void);
+	/*
+	USAGE: Adds a box at the end of the store
+	ARGUMENTS:
+	-	vector3 const& a_v3Min -> minimum in global space
+	-	vector3 const& a_v3Max -> maximum in global space
+	OUTPUT: ---
+	*/
+	void Add(vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Changes the box specified by index
+	ARGUMENTS:
+	-	uint a_uIndex -> index of the box
+	-	vector3 const& a_v3Min -> minimum in global space
+	-	vector3 const& a_v3Max -> maximum in global space
+	OUTPUT: ---
+	*/
+	void Set(uint a_uIndex, vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Removes the box specified by index moving the last box into its place
+	ARGUMENTS: uint a_uIndex -> index of the box
+	OUTPUT: ---
+	*/
+	void Remove(uint a_uIndex);
+	/*
+	USAGE: Gets the minimum of the box specified by index
+	ARGUMENTS: uint a_uIndex -> index of the box
+	OUTPUT: minimum in global space
+	*/
+	vector3 GetMin(uint a_uIndex);
+	/*
+	USAGE: Gets the maximum of the box specified by index
+	ARGUMENTS: uint a_uIndex -> index of the box
+	OUTPUT: maximum in global space
+	*/
+	vector3 GetMax(uint a_uIndex);
+	/*
+	USAGE: Tests a box against up to m_uBatch consecutive boxes of the store at once
+	ARGUMENTS:
+	-	vector3 const& a_v3Min -> minimum of the tested box
+	-	vector3 const& a_v3Max -> maximum of the tested box
+	-	uint a_uFirst -> first box of the store to test against
+	-	uint a_uCount -> number of boxes to test against, clamped to m_uBatch and the store
+	OUTPUT: bit k is set if the box a_uFirst + k overlaps the tested box
+	*/
+	uint OverlapMask(vector3 const& a_v3Min, vector3 const& a_v3Max, uint a_uFirst, uint a_uCount);
+	/*
+	USAGE: Tests a box against up to m_uBatch boxes of the store picked by index at once
+	ARGUMENTS:
+	-	vector3 const& a_v3Min -> minimum of the tested box
+	-	vector3 const& a_v3Max -> maximum of the tested box
+	-	uint const* a_pIndex -> index of the boxes of the store to test against, the ones
+		out of the store never overlap
+	-	uint a_uCount -> number of indices, clamped to m_uBatch
+	OUTPUT: bit k is set if the box a_pIndex[k] overlaps the tested box
+	*/
+	uint OverlapMask(vector3 const& a_v3Min, vector3 const& a_v3Max, uint const* a_pIndex, uint a_uCount);
+
+private:
+	/*
+	USAGE: Tests a box against the m_uBatch boxes starting at the given pointers
+	ARGUMENTS:
+	-	vector3 const& a_v3Min -> minimum of the tested box
+	-	vector3 const& a_v3Max -> maximum of the tested box
+	-	float const* a_pMinX ... a_pMaxZ -> first of m_uBatch values of each array
+	OUTPUT: bit k is set if box k overlaps the tested box
+	*/
+	static uint OverlapBatch(vector3 const& a_v3Min, vector3 const& a_v3Max,
+		float const* a_pMinX, float const* a_pMinY, float const* a_pMinZ,
+		float const* a_pMaxX, float const* a_pMaxY, float const* a_pMaxZ);
+};//class
+
+} //namespace Simplex
+
+#endif //__MYAABBSTORE_H_
@@ -0,0 +1,336 @@
+#include "MyDynamicTree.h"
+using namespace Simplex;
+//  MyDynamicTree
+void Simplex::MyDynamicTree::Clear(void)
+{
+	m_lNode.clear();
+	m_uRoot = static_cast<uint>(-1);
+	m_uFreeNode = static_cast<uint>(-1);
+	m_lKeyLeaf.clear();
+	m_lDirtyLeaf.clear();
+	m_uLeafCount = 0;
+}
+void Simplex::MyDynamicTree::SetMargin(float a_fMargin) { m_fMargin = std::max(a_fMargin, 0.0f); }
+float Simplex::MyDynamicTree::GetMargin(void) { return m_fMargin; }
+uint Simplex::MyDynamicTree::GetLeafCount(void) { return m_uLeafCount; }
+uint Simplex::MyDynamicTree::GetHeight(void)
+{
+	if (m_uRoot == static_cast<uint>(-1))
+		return 0;
+	return static_cast<uint>(m_lNode[m_uRoot].m_nHeight);
+}
+uint Simplex::MyDynamicTree::AllocateNode(void)
+{
+	if (m_uFreeNode == static_cast<uint>(-1))
+	{
+		m_lNode.push_back(Node());
+		return static_cast<uint>(m_lNode.size() - 1);
+	}
+	uint uNode = m_uFreeNode;
+	m_uFreeNode = m_lNode[uNode].m_uParent;
+	m_lNode[uNode] = Node();
+	return uNode;
+}
+void Simplex::MyDynamicTree::FreeNode(uint a_uNode)
+{
+	m_lNode[a_uNode].m_nHeight = -1;
+	m_lNode[a_uNode].m_uParent = m_uFreeNode;
+	m_uFreeNode = a_uNode;
+}
+void Simplex::MyDynamicTree::Insert(uint a_uKey, vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	if (a_uKey >= m_lKeyLeaf.size())
+		m_lKeyLeaf.resize(a_uKey + 1, static_cast<uint>(-1));
+	if (m_lKeyLeaf[a_uKey] != static_cast<uint>(-1))
+		Remove(a_uKey);
+
+	uint uLeaf = AllocateNode();
+	Node& leaf = m_lNode[uLeaf];
+	leaf.m_v3Min = a_v3Min - vector3(m_fMargin);
+	leaf.m_v3Max = a_v3Max + vector3(m_fMargin);
+	leaf.m_nHeight = 0;
+	leaf.m_uKey = a_uKey;
+	m_lKeyLeaf[a_uKey] = uLeaf;
+	++m_uLeafCount;
+	InsertLeaf(uLeaf);
+}
+void Simplex::MyDynamicTree::Remove(uint a_uKey)
+{
+	if (a_uKey >= m_lKeyLeaf.size() || m_lKeyLeaf[a_uKey] == static_cast<uint>(-1))
+		return;
+	uint uLeaf = m_lKeyLeaf[a_uKey];
+	RemoveLeaf(uLeaf);
+	FreeNode(uLeaf);
+	m_lKeyLeaf[a_uKey] = static_cast<uint>(-1);
+	--m_uLeafCount;
+}
+bool Simplex::MyDynamicTree::Move(uint a_uKey, vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	if (a_uKey >= m_lKeyLeaf.size() || m_lKeyLeaf[a_uKey] == static_cast<uint>(-1))
+		return false;
+
+	//small moves stay inside the fattened box and leave the tree as it is
+	uint uLeaf = m_lKeyLeaf[a_uKey];
+	Node& leaf = m_lNode[uLeaf];
+	if (leaf.m_v3Min.x <= a_v3Min.x && leaf.m_v3Min.y <= a_v3Min.y && leaf.m_v3Min.z <= a_v3Min.z &&
+		leaf.m_v3Max.x >= a_v3Max.x && leaf.m_v3Max.y >= a_v3Max.y && leaf.m_v3Max.z >= a_v3Max.z)
+		return false;
+
+	RemoveLeaf(uLeaf);
+	leaf.m_v3Min = a_v3Min - vector3(m_fMargin);
+	leaf.m_v3Max = a_v3Max + vector3(m_fMargin);
+	InsertLeaf(uLeaf);
+	return true;
+}
+float Simplex::MyDynamicTree::GetArea(vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	vector3 v3Size = a_v3Max - a_v3Min;
+	return 2.0f * (v3Size.x * v3Size.y + v3Size.y * v3Size.z + v3Size.z * v3Size.x);
+}
+bool Simplex::MyDynamicTree::IsOverlapping(Node const& a_NodeA, Node const& a_NodeB)
+{
+	return !(a_NodeA.m_v3Max.x < a_NodeB.m_v3Min.x || a_NodeA.m_v3Min.x > a_NodeB.m_v3Max.x ||
+		a_NodeA.m_v3Max.y < a_NodeB.m_v3Min.y || a_NodeA.m_v3Min.y > a_NodeB.m_v3Max.y ||
+		a_NodeA.m_v3Max.z < a_NodeB.m_v3Min.z || a_NodeA.m_v3Min.z > a_NodeB.m_v3Max.z);
+}
+void Simplex::MyDynamicTree::InsertLeaf(uint a_uLeaf)
+{
+	if (m_uRoot == static_cast<uint>(-1))
+	{
+		m_uRoot = a_uLeaf;
+		m_lNode[a_uLeaf].m_uParent = static_cast<uint>(-1);
+		return;
+	}
+
+	//walk down while going into a child is cheaper than making a sibling here, the cost
+	//is the surface the new branch adds plus what every ancestor grows by
+	vector3 v3Min = m_lNode[a_uLeaf].m_v3Min;
+	vector3 v3Max = m_lNode[a_uLeaf].m_v3Max;
+	uint uIndex = m_uRoot;
+	while (m_lNode[uIndex].m_nHeight > 0)
+	{
+		Node const& node = m_lNode[uIndex];
+		float fArea = GetArea(node.m_v3Min, node.m_v3Max);
+		float fCombinedArea = GetArea(glm::min(node.m_v3Min, v3Min), glm::max(node.m_v3Max, v3Max));
+		float fCost = 2.0f * fCombinedArea;
+		float fInheritanceCost = 2.0f * (fCombinedArea - fArea);
+
+		float fChildCost[2];
+		for (uint i = 0; i < 2; ++i)
+		{
+			Node const& child = m_lNode[node.m_uChild[i]];
+			float fChildArea = GetArea(glm::min(child.m_v3Min, v3Min), glm::max(child.m_v3Max, v3Max));
+			if (child.m_nHeight > 0)
+				fChildArea -= GetArea(child.m_v3Min, child.m_v3Max);
+			fChildCost[i] = fChildArea + fInheritanceCost;
+		}
+		if (fCost < fChildCost[0] && fCost < fChildCost[1])
+			break;
+		uIndex = fChildCost[0] < fChildCost[1] ? node.m_uChild[0] : node.m_uChild[1];
+	}
+
+	//a new branch takes the place of the sibling and holds both
+	uint uSibling = uIndex;
+	uint uOldParent = m_lNode[uSibling].m_uParent;
+	uint uNewParent = AllocateNode();
+	Node& newParent = m_lNode[uNewParent];
+	newParent.m_uParent = uOldParent;
+	newParent.m_v3Min = glm::min(m_lNode[uSibling].m_v3Min, v3Min);
+	newParent.m_v3Max = glm::max(m_lNode[uSibling].m_v3Max, v3Max);
+	newParent.m_nHeight = m_lNode[uSibling].m_nHeight + 1;
+	newParent.m_uChild[0] = uSibling;
+	newParent.m_uChild[1] = a_uLeaf;
+	if (uOldParent != static_cast<uint>(-1))
+	{
+		Node& oldParent = m_lNode[uOldParent];
+		oldParent.m_uChild[oldParent.m_uChild[0] == uSibling ? 0 : 1] = uNewParent;
+	}
+	else
+	{
+		m_uRoot = uNewParent;
+	}
+	m_lNode[uSibling].m_uParent = uNewParent;
+	m_lNode[a_uLeaf].m_uParent = uNewParent;
+
+	Refit(m_lNode[a_uLeaf].m_uParent);
+}
+void Simplex::MyDynamicTree::RemoveLeaf(uint a_uLeaf)
+{
+	if (a_uLeaf == m_uRoot)
+	{
+		m_uRoot = static_cast<uint>(-1);
+		return;
+	}
+
+	//the sibling takes the place of the parent, which goes away
+	uint uParent = m_lNode[a_uLeaf].m_uParent;
+	uint uGrandParent = m_lNode[uParent].m_uParent;
+	uint uSibling = m_lNode[uParent].m_uChild[m_lNode[uParent].m_uChild[0] == a_uLeaf ? 1 : 0];
+	if (uGrandParent != static_cast<uint>(-1))
+	{
+		Node& grandParent = m_lNode[uGrandParent];
+		grandParent.m_uChild[grandParent.m_uChild[0] == uParent ? 0 : 1] = uSibling;
+		m_lNode[uSibling].m_uParent = uGrandParent;
+		FreeNode(uParent);
+		Refit(uGrandParent);
+	}
+	else
+	{
+		m_uRoot = uSibling;
+		m_lNode[uSibling].m_uParent = static_cast<uint>(-1);
+		FreeNode(uParent);
+	}
+}
+void Simplex::MyDynamicTree::Refit(uint a_uNode)
+{
+	uint uIndex = a_uNode;
+	while (uIndex != static_cast<uint>(-1))
+	{
+		uIndex = Balance(uIndex);
+		Node& node = m_lNode[uIndex];
+		Node const& childA = m_lNode[node.m_uChild[0]];
+		Node const& childB = m_lNode[node.m_uChild[1]];
+		node.m_nHeight = 1 + std::max(childA.m_nHeight, childB.m_nHeight);
+		node.m_v3Min = glm::min(childA.m_v3Min, childB.m_v3Min);
+		node.m_v3Max = glm::max(childA.m_v3Max, childB.m_v3Max);
+		uIndex = node.m_uParent;
+	}
+}
+uint Simplex::MyDynamicTree::Balance(uint a_uNode)
+{
+	uint uA = a_uNode;
+	Node& A = m_lNode[uA];
+	if (A.m_nHeight < 2)
+		return uA;
+
+	//rotate the taller child up, its taller child stays under it and A takes the other
+	uint uB = A.m_uChild[0];
+	uint uC = A.m_uChild[1];
+	int nBalance = m_lNode[uC].m_nHeight - m_lNode[uB].m_nHeight;
+	if (nBalance > -2 && nBalance < 2)
+		return uA;
+
+	//A keeps the short child at uShortSide, the tall child rises
+	uint uTallSide = nBalance > 0 ? 1 : 0;
+	uint uTall = A.m_uChild[uTallSide];
+	uint uShort = A.m_uChild[1 - uTallSide];
+	Node& tall = m_lNode[uTall];
+	uint uF = tall.m_uChild[0];
+	uint uG = tall.m_uChild[1];
+
+	//the tall child takes the place of A
+	tall.m_uChild[0] = uA;
+	tall.m_uParent = A.m_uParent;
+	A.m_uParent = uTall;
+	if (tall.m_uParent != static_cast<uint>(-1))
+	{
+		Node& parent = m_lNode[tall.m_uParent];
+		parent.m_uChild[parent.m_uChild[0] == uA ? 0 : 1] = uTall;
+	}
+	else
+	{
+		m_uRoot = uTall;
+	}
+
+	//the taller grandchild stays with the risen node, the other one goes to A
+	uint uKeep = m_lNode[uF].m_nHeight > m_lNode[uG].m_nHeight ? uF : uG;
+	uint uGive = uKeep == uF ? uG : uF;
+	tall.m_uChild[1] = uKeep;
+	A.m_uChild[uTallSide] = uGive;
+	m_lNode[uGive].m_uParent = uA;
+
+	Node const& shortNode = m_lNode[uShort];
+	Node const& give = m_lNode[uGive];
+	Node const& keep = m_lNode[uKeep];
+	A.m_v3Min = glm::min(shortNode.m_v3Min, give.m_v3Min);
+	A.m_v3Max = glm::max(shortNode.m_v3Max, give.m_v3Max);
+	A.m_nHeight = 1 + std::max(shortNode.m_nHeight, give.m_nHeight);
+	tall.m_v3Min = glm::min(A.m_v3Min, keep.m_v3Min);
+	tall.m_v3Max = glm::max(A.m_v3Max, keep.m_v3Max);
+	tall.m_nHeight = 1 + std::max(A.m_nHeight, keep.m_nHeight);
+	return uTall;
+}
+void Simplex::MyDynamicTree::SetDirty(uint a_uKey)
+{
+	if (a_uKey >= m_lKeyLeaf.size() || m_lKeyLeaf[a_uKey] == static_cast<uint>(-1))
+		return;
+
+	//the ancestors of a marked branch are already marked
+	uint uIndex = m_lKeyLeaf[a_uKey];
+	if (m_lNode[uIndex].m_bDirty)
+		return;
+	m_lDirtyLeaf.push_back(uIndex);
+	while (uIndex != static_cast<uint>(-1) && !m_lNode[uIndex].m_bDirty)
+	{
+		m_lNode[uIndex].m_bDirty = true;
+		uIndex = m_lNode[uIndex].m_uParent;
+	}
+}
+void Simplex::MyDynamicTree::ComputePairs(std::vector<uint>& a_lPair)
+{
+	if (m_uRoot != static_cast<uint>(-1))
+		SelfPairs(m_uRoot, a_lPair);
+
+	for (uint i = 0; i < m_lDirtyLeaf.size(); ++i)
+	{
+		uint uIndex = m_lDirtyLeaf[i];
+		while (uIndex != static_cast<uint>(-1) && m_lNode[uIndex].m_bDirty)
+		{
+			m_lNode[uIndex].m_bDirty = false;
+			uIndex = m_lNode[uIndex].m_uParent;
+		}
+	}
+	m_lDirtyLeaf.clear();
+}
+void Simplex::MyDynamicTree::SelfPairs(uint a_uNode, std::vector<uint>& a_lPair)
+{
+	//the pairs inside an unmarked subtree are not wanted
+	Node const& node = m_lNode[a_uNode];
+	if (node.m_nHeight == 0 || !node.m_bDirty)
+		return;
+	SelfPairs(node.m_uChild[0], a_lPair);
+	SelfPairs(node.m_uChild[1], a_lPair);
+	CrossPairs(node.m_uChild[0], node.m_uChild[1], a_lPair);
+}
+void Simplex::MyDynamicTree::CrossPairs(uint a_uNodeA, uint a_uNodeB, std::vector<uint>& a_lPair)
+{
+	Node const& nodeA = m_lNode[a_uNodeA];
+	Node const& nodeB = m_lNode[a_uNodeB];
+	if ((!nodeA.m_bDirty && !nodeB.m_bDirty) || !IsOverlapping(nodeA, nodeB))
+		return;
+	if (nodeA.m_nHeight == 0 && nodeB.m_nHeight == 0)
+	{
+		a_lPair.push_back(nodeA.m_uKey);
+		a_lPair.push_back(nodeB.m_uKey);
+		return;
+	}
+
+	//descend the larger subtree so both sides shrink at the same pace
+	if (nodeB.m_nHeight == 0 || (nodeA.m_nHeight > 0 && GetArea(nodeA.m_v3Min, nodeA.m_v3Max) >= GetArea(nodeB.m_v3Min, nodeB.m_v3Max)))
+	{
+		CrossPairs(nodeA.m_uChild[0], a_uNodeB, a_lPair);
+		CrossPairs(nodeA.m_uChild[1], a_uNodeB, a_lPair);
+	}
+	else
+	{
+		CrossPairs(a_uNodeA, nodeB.m_uChild[0], a_lPair);
+		CrossPairs(a_uNodeA, nodeB.m_uChild[1], a_lPair);
+	}
+}
+void Simplex::MyDynamicTree::Display(uint a_uDepth, vector3 a_v3Color)
+{
+	if (m_uRoot != static_cast<uint>(-1))
+		DisplayNode(m_uRoot, 0, a_uDepth, a_v3Color);
+}
+void Simplex::MyDynamicTree::DisplayNode(uint a_uNode, uint a_uDepth, uint a_uMaxDepth, vector3 a_v3Color)
+{
+	if (a_uDepth > a_uMaxDepth)
+		return;
+	Node const& node = m_lNode[a_uNode];
+	vector3 v3Center = (node.m_v3Min + node.m_v3Max) / 2.0f;
+	MeshManager::GetInstance()->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, v3Center) * glm::scale(node.m_v3Max - node.m_v3Min), a_v3Color, RENDER_WIRE);
+	if (node.m_nHeight == 0)
+		return;
+	DisplayNode(node.m_uChild[0], a_uDepth + 1, a_uMaxDepth, a_v3Color);
+	DisplayNode(node.m_uChild[1], a_uDepth + 1, a_uMaxDepth, a_v3Color);
+}
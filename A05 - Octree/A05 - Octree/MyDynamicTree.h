@@ -0,0 +1,202 @@
+/*----------------------------------------------
+Programmer: Alberto Bobadilla (labigm@gmail.com)
+Date: 2017/07
+----------------------------------------------*/
+#ifndef __MYDYNAMICTREE_H_
+#define __MYDYNAMICTREE_H_
+
+#include "Simplex\Simplex.h"
+
+namespace Simplex
+{
+
+//Bounding volume hierarchy of fattened global boxes, each leaf is identified by a key
+//(the handle slot of its entity) and the tree is kept balanced with rotations
+class MyDynamicTree
+{
+	//a leaf holds a fattened box, a branch the union of its two children
+	struct Node
+	{
+		vector3 m_v3Min = ZERO_V3; //minimum in global space
+		vector3 m_v3Max = ZERO_V3; //maximum in global space
+		uint m_uParent = static_cast<uint>(-1); //parent node, next free node while the node is free
+		uint m_uChild[2] = { static_cast<uint>(-1), static_cast<uint>(-1) }; //children, -1 for a leaf
+		int m_nHeight = -1; //0 for a leaf, -1 while the node is free
+		uint m_uKey = static_cast<uint>(-1); //key of a leaf
+		bool m_bDirty = false; //does this subtree hold a leaf marked with SetDirty?
+	};
+
+	std::vector<Node> m_lNode; //every node, freed ones are chained through their parent
+	uint m_uRoot = static_cast<uint>(-1); //root node, -1 if the tree is empty
+	uint m_uFreeNode = static_cast<uint>(-1); //first free node
+	std::vector<uint> m_lKeyLeaf; //leaf of each key, -1 if the key is not in the tree
+	std::vector<uint> m_lDirtyLeaf; //leafs marked since the last ComputePairs
+	float m_fMargin = 0.2f; //distance the leaf boxes are fattened by on every side
+	uint m_uLeafCount = 0; //number of leafs
+public:
+	/*
+	USAGE: Removes every leaf, the memory is kept
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Clear(void);
+	/*
+	USAGE: Adds a leaf with a fattened copy of the box, replacing the one of the key if any
+	ARGUMENTS:
+	-	uint a_uKey -> key of the leaf
+	-	vector3 const& a_v3Min -> minimum in global space
+	-	vector3 const& a_v3Max -> maximum in global space
+	OUTPUT: ---
+	*/
+	void Insert(uint a_uKey, vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Removes the leaf of the key
+	ARGUMENTS: uint a_uKey -> key of the leaf
+	OUTPUT: ---
+	*/
+	void Remove(uint a_uKey);
+	/*
+	USAGE: Updates the box of the leaf of the key, the leaf is only reinserted if the box
+	left its fattened box
+	ARGUMENTS:
+	-	uint a_uKey -> key of the leaf
+	-	vector3 const& a_v3Min -> minimum in global space
+	-	vector3 const& a_v3Max -> maximum in global space
+	OUTPUT: was the leaf reinserted?
+	*/
+	bool Move(uint a_uKey, vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Marks the leaf of the key so ComputePairs looks for its pairs, the tree must not
+	change between the marks and ComputePairs
+	ARGUMENTS: uint a_uKey -> key of the leaf
+	OUTPUT: ---
+	*/
+	void SetDirty(uint a_uKey);
+	/*
+	USAGE: Descends the tree against itself to find the leafs whose fattened boxes overlap,
+	only pairs with at least one marked leaf are reported, each one once. Clears the marks
+	ARGUMENTS:
+	-	std::vector<uint>& a_lPair -> list the pairs are appended to, two keys per pair
+	OUTPUT: ---
+	*/
+	void ComputePairs(std::vector<uint>& a_lPair);
+	/*
+	USAGE: Sets the distance the leaf boxes are fattened by, applies to the next insertions
+	ARGUMENTS: float a_fMargin -> margin in global units
+	OUTPUT: ---
+	*/
+	void SetMargin(float a_fMargin);
+	/*
+	USAGE: Gets the distance the leaf boxes are fattened by
+	ARGUMENTS: ---
+	OUTPUT: margin in global units
+	*/
+	float GetMargin(void);
+	/*
+	USAGE: Gets the number of leafs in the tree
+	ARGUMENTS: ---
+	OUTPUT: leaf count
+	*/
+	uint GetLeafCount(void);
+	/*
+	USAGE: Gets the height of the tree
+	ARGUMENTS: ---
+	OUTPUT: height, 0 for a single leaf or an empty tree
+	*/
+	uint GetHeight(void);
+	/*
+	USAGE: Displays the box of every node down to the specified depth
+	ARGUMENTS:
+	-	uint a_uDepth = -1 -> deepest level to display, the root is 0
+	-	vector3 a_v3Color = C_YELLOW -> Color of the volumes to display
+	OUTPUT: ---
+	*/
+	void Display(uint a_uDepth = -1, vector3 a_v3Color = C_YELLOW);
+
+private:
+	/*
+	USAGE: Takes a node from the free list, growing the list if it is empty
+	ARGUMENTS: ---
+	OUTPUT: index of the node
+	*/
+	uint AllocateNode(void);
+	/*
+	USAGE: Puts a node back in the free list
+	ARGUMENTS: uint a_uNode -> index of the node
+	OUTPUT: ---
+	*/
+	void FreeNode(uint a_uNode);
+	/*
+	USAGE: Links a leaf next to the sibling that grows the total surface of the tree the
+	least, then refits and balances its ancestors
+	ARGUMENTS: uint a_uLeaf -> index of the leaf
+	OUTPUT: ---
+	*/
+	void InsertLeaf(uint a_uLeaf);
+	/*
+	USAGE: Unlinks a leaf, its sibling takes the place of their parent, then refits and
+	balances the ancestors
+	ARGUMENTS: uint a_uLeaf -> index of the leaf
+	OUTPUT: ---
+	*/
+	void RemoveLeaf(uint a_uLeaf);
+	/*
+	USAGE: Refits and balances every node from the one specified up to the root
+	ARGUMENTS: uint a_uNode -> index of the first node
+	OUTPUT: ---
+	*/
+	void Refit(uint a_uNode);
+	/*
+	USAGE: Rotates the taller grandchild up if the children heights differ by more than one
+	ARGUMENTS: uint a_uNode -> index of the node
+	OUTPUT: index of the node now in its place
+	*/
+	uint Balance(uint a_uNode);
+	/*
+	USAGE: Reports the pairs between the two children of every marked branch under the node
+	ARGUMENTS:
+	-	uint a_uNode -> index of the node
+	-	std::vector<uint>& a_lPair -> list the pairs are appended to
+	OUTPUT: ---
+	*/
+	void SelfPairs(uint a_uNode, std::vector<uint>& a_lPair);
+	/*
+	USAGE: Reports the pairs of overlapping leafs between two subtrees, descending the larger one
+	ARGUMENTS:
+	-	uint a_uNodeA -> index of the first subtree
+	-	uint a_uNodeB -> index of the second subtree
+	-	std::vector<uint>& a_lPair -> list the pairs are appended to
+	OUTPUT: ---
+	*/
+	void CrossPairs(uint a_uNodeA, uint a_uNodeB, std::vector<uint>& a_lPair);
+	/*
+	USAGE: Gets the surface area of a box
+	ARGUMENTS:
+	-	vector3 const& a_v3Min -> minimum of the box
+	-	vector3 const& a_v3Max -> maximum of the box
+	OUTPUT: surface area
+	*/
+	static float GetArea(vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Asks if the boxes of two nodes overlap
+	ARGUMENTS:
+	-	Node const& a_NodeA -> first node
+	-	Node const& a_NodeB -> second node
+	OUTPUT: do they overlap?
+	*/
+	static bool IsOverlapping(Node const& a_NodeA, Node const& a_NodeB);
+	/*
+	USAGE: Displays the box of the node and of its descendants down to the depth
+	ARGUMENTS:
+	-	uint a_uNode -> index of the node
+	-	uint a_uDepth -> depth of the node
+	-	uint a_uMaxDepth -> deepest level to display
+	-	vector3 a_v3Color -> Color of the volumes to display
+	OUTPUT: ---
+	*/
+	void DisplayNode(uint a_uNode, uint a_uDepth, uint a_uMaxDepth, vector3 a_v3Color);
+};//class
+
+} //namespace Simplex
+
+#endif //__MYDYNAMICTREE_H_
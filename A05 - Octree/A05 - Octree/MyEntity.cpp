@@ -1,6 +1,7 @@
 #include "MyEntity.h"
 using namespace Simplex;
 std::map<String, MyEntity*> MyEntity::m_IDMap;
+std::map<String, MyEntity::ModelCacheEntry> MyEntity::m_ModelCache;
 //  Accessors
 matrix4 Simplex::MyEntity::GetModelMatrix(void){ return m_m4ToWorld; }
 void Simplex::MyEntity::SetModelMatrix(matrix4 a_m4ToWorld)
@@ -8,14 +9,16 @@ void Simplex::MyEntity::SetModelMatrix(matrix4 a_m4ToWorld)
 	if (!m_bInMemory)
 		return;
 
+	//the model is shared, it gets the matrix when this entity is rendered
 	m_m4ToWorld = a_m4ToWorld;
-	m_pModel->SetModelMatrix(m_m4ToWorld);
 	m_pRigidBody->SetModelMatrix(m_m4ToWorld);
 }
 Model* Simplex::MyEntity::GetModel(void){return m_pModel;}
 MyRigidBody* Simplex::MyEntity::GetRigidBody(void){	return m_pRigidBody; }
 bool Simplex::MyEntity::IsInitialized(void){ return m_bInMemory; }
 String Simplex::MyEntity::GetUniqueID(void) { return m_sUniqueID; }
+void Simplex::MyEntity::SetHandleSlot(uint a_uSlot) { m_uHandleSlot = a_uSlot; }
+Simplex::uint Simplex::MyEntity::GetHandleSlot(void) { return m_uHandleSlot; }
 void Simplex::MyEntity::SetAxisVisible(bool a_bSetAxis) { m_bSetAxis = a_bSetAxis; }
 //  MyEntity
 void Simplex::MyEntity::Init(void)
@@ -25,10 +28,12 @@ void Simplex::MyEntity::Init(void)
 	m_bSetAxis = false;
 	m_pModel = nullptr;
 	m_pRigidBody = nullptr;
-	m_DimensionArray = nullptr;
+	m_DimensionArray = m_DimensionInline;
 	m_m4ToWorld = IDENTITY_M4;
 	m_sUniqueID = "";
+	m_uHandleSlot = static_cast<uint>(-1);
 	m_nDimensionCount = 0;
+	m_nDimensionCapacity = m_uDimensionInline;
 }
 void Simplex::MyEntity::Swap(MyEntity& other)
 {
@@ -39,9 +44,19 @@ void Simplex::MyEntity::Swap(MyEntity& other)
 	std::swap(m_pMeshMngr, other.m_pMeshMngr);
 	std::swap(m_bInMemory, other.m_bInMemory);
 	std::swap(m_sUniqueID, other.m_sUniqueID);
+	std::swap(m_uHandleSlot, other.m_uHandleSlot);
 	std::swap(m_bSetAxis, other.m_bSetAxis);
+	//an array in the inline storage has to move with the storage, not with the pointer
+	bool bInline = m_DimensionArray == m_DimensionInline;
+	bool bOtherInline = other.m_DimensionArray == other.m_DimensionInline;
 	std::swap(m_nDimensionCount, other.m_nDimensionCount);
+	std::swap(m_nDimensionCapacity, other.m_nDimensionCapacity);
 	std::swap(m_DimensionArray, other.m_DimensionArray);
+	std::swap_ranges(m_DimensionInline, m_DimensionInline + m_uDimensionInline, other.m_DimensionInline);
+	if (bInline)
+		other.m_DimensionArray = other.m_DimensionInline;
+	if (bOtherInline)
+		m_DimensionArray = m_DimensionInline;
 }
 void Simplex::MyEntity::Release(void)
 {
@@ -49,11 +64,13 @@ void Simplex::MyEntity::Release(void)
 	//it is not the job of the entity to release the model, 
 	//it is for the mesh manager to do so.
 	m_pModel = nullptr;
-	if (m_DimensionArray)
+	if (m_DimensionArray != m_DimensionInline)
 	{
 		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
+		m_DimensionArray = m_DimensionInline;
 	}
+	m_nDimensionCount = 0;
+	m_nDimensionCapacity = m_uDimensionInline;
 	SafeDelete(m_pRigidBody);
 	m_IDMap.erase(m_sUniqueID);
 }
@@ -61,15 +78,32 @@ void Simplex::MyEntity::Release(void)
 Simplex::MyEntity::MyEntity(String a_sFileName, String a_sUniqueID)
 {
 	Init();
-	m_pModel = new Model();
-	m_pModel->Load(a_sFileName);
+	//load the file only the first time it is asked for
+	auto cached = m_ModelCache.find(a_sFileName);
+	if (cached == m_ModelCache.end())
+	{
+		m_pModel = new Model();
+		m_pModel->Load(a_sFileName);
+		//if the model is loaded keep it along with its local box
+		if (m_pModel->GetName() != "")
+		{
+			MyRigidBody rigidBody(m_pModel->GetVertexList());
+			ModelCacheEntry entry;
+			entry.m_pModel = m_pModel;
+			entry.m_lBoundingPoint.push_back(rigidBody.GetMinLocal());
+			entry.m_lBoundingPoint.push_back(rigidBody.GetMaxLocal());
+			cached = m_ModelCache.insert(std::make_pair(a_sFileName, entry)).first;
+		}
+	}
 	//if the model is loaded
-	if (m_pModel->GetName() != "")
+	if (cached != m_ModelCache.end())
 	{
+		m_pModel = cached->second.m_pModel;
 		GenUniqueID(a_sUniqueID);
 		m_sUniqueID = a_sUniqueID;
 		m_IDMap[a_sUniqueID] = this;
-		m_pRigidBody = new MyRigidBody(m_pModel->GetVertexList()); //generate a rigid body
+		//the box of the two cached corners is the box of the whole vertex list
+		m_pRigidBody = new MyRigidBody(cached->second.m_lBoundingPoint); //generate a rigid body
 		m_bInMemory = true; //mark this entity as viable
 	}
 }
@@ -83,9 +117,10 @@ Simplex::MyEntity::MyEntity(MyEntity const& other)
 	m_pMeshMngr = other.m_pMeshMngr;
 	m_sUniqueID = other.m_sUniqueID;
 	m_bSetAxis = other.m_bSetAxis;
+	//the dimensions are copied, sharing the array would free it twice
+	ReserveDimensions(other.m_nDimensionCount);
+	memcpy(m_DimensionArray, other.m_DimensionArray, sizeof(uint) * other.m_nDimensionCount);
 	m_nDimensionCount = other.m_nDimensionCount;
-	m_DimensionArray = other.m_DimensionArray;
-
 }
 MyEntity& Simplex::MyEntity::operator=(MyEntity const& other)
 {
@@ -106,7 +141,8 @@ void Simplex::MyEntity::AddToRenderList(bool a_bDrawRigidBody)
 	if (!m_bInMemory)
 		return;
 
-	//draw model
+	//draw model, it is shared so it takes this entity's matrix first
+	m_pModel->SetModelMatrix(m_m4ToWorld);
 	m_pModel->AddToRenderList();
 	
 	//draw rigid body
@@ -139,73 +175,61 @@ void Simplex::MyEntity::GenUniqueID(String& a_sUniqueID)
 }
 void Simplex::MyEntity::AddDimension(uint a_uDimension)
 {
-	//we need to check that this dimension is not already allocated in the list
-	if (IsInDimension(a_uDimension))
-		return;//it is, so there is no need to add
+	//find where the dimension goes in the sorted array
+	uint* pEnd = m_DimensionArray + m_nDimensionCount;
+	uint* pSpot = std::lower_bound(m_DimensionArray, pEnd, a_uDimension);
+	if (pSpot != pEnd && *pSpot == a_uDimension)
+		return;//it is already there, so there is no need to add
 
-	//insert the entry
-	uint* pTemp;
-	pTemp = new uint[m_nDimensionCount + 1];
-	if(m_DimensionArray)
-	{
-		memcpy(pTemp, m_DimensionArray, sizeof(uint) * m_nDimensionCount);
-		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
-	}
-	pTemp[m_nDimensionCount] = a_uDimension;
-	m_DimensionArray = pTemp;
+	uint uSpot = static_cast<uint>(pSpot - m_DimensionArray);
+	if (m_nDimensionCount == m_nDimensionCapacity)
+		ReserveDimensions(m_nDimensionCapacity * 2);
 
+	//open a gap for the entry, the octrees add in increasing order so this is usually empty
+	memmove(m_DimensionArray + uSpot + 1, m_DimensionArray + uSpot, sizeof(uint) * (m_nDimensionCount - uSpot));
+	m_DimensionArray[uSpot] = a_uDimension;
 	++m_nDimensionCount;
-
-	SortDimensions();
 }
 void Simplex::MyEntity::RemoveDimension(uint a_uDimension)
 {
-	//if there are no dimensions return
-	if (m_nDimensionCount == 0)
+	uint* pEnd = m_DimensionArray + m_nDimensionCount;
+	uint* pSpot = std::lower_bound(m_DimensionArray, pEnd, a_uDimension);
+	if (pSpot == pEnd || *pSpot != a_uDimension)
 		return;
 
-	//we look one by one if its the one wanted
-	for (uint i = 0; i < m_nDimensionCount; i++)
-	{
-		if (m_DimensionArray[i] == a_uDimension)
-		{
-			//if it is, then we swap it with the last one and then we pop
-			std::swap(m_DimensionArray[i], m_DimensionArray[m_nDimensionCount - 1]);
-			uint* pTemp;
-			pTemp = new uint[m_nDimensionCount - 1];
-			if (m_DimensionArray)
-			{
-				memcpy(pTemp, m_DimensionArray, sizeof(uint) * (m_nDimensionCount-1));
-				delete[] m_DimensionArray;
-				m_DimensionArray = nullptr;
-			}
-			m_DimensionArray = pTemp;
-			
-			--m_nDimensionCount;
-			SortDimensions();
-			return;
-		}
-	}
+	//close the gap keeping the order
+	uint uSpot = static_cast<uint>(pSpot - m_DimensionArray);
+	memmove(m_DimensionArray + uSpot, m_DimensionArray + uSpot + 1, sizeof(uint) * (m_nDimensionCount - uSpot - 1));
+	--m_nDimensionCount;
 }
 void Simplex::MyEntity::ClearDimensionSet(void)
 {
-	if (m_DimensionArray)
-	{
-		delete[] m_DimensionArray;
-		m_DimensionArray = nullptr;
-	}
+	//the octrees reassign every entity each time they are built, keep the array for them
 	m_nDimensionCount = 0;
 }
 bool Simplex::MyEntity::IsInDimension(uint a_uDimension)
 {
 	//see if the entry is in the set
-	for (uint i = 0; i < m_nDimensionCount; i++)
-	{
-		if (m_DimensionArray[i] == a_uDimension)
-			return true;
-	}
-	return false;
+	return std::binary_search(m_DimensionArray, m_DimensionArray + m_nDimensionCount, a_uDimension);
+}
+void Simplex::MyEntity::ReserveDimensions(uint a_uCapacity)
+{
+	if (a_uCapacity <= m_nDimensionCapacity)
+		return;
+
+	uint* pTemp = new uint[a_uCapacity];
+	memcpy(pTemp, m_DimensionArray, sizeof(uint) * m_nDimensionCount);
+	if (m_DimensionArray != m_DimensionInline)
+		delete[] m_DimensionArray;
+	m_DimensionArray = pTemp;
+	m_nDimensionCapacity = a_uCapacity;
+}
+uint Simplex::MyEntity::GetDimensionCount(void) { return m_nDimensionCount; }
+uint Simplex::MyEntity::GetDimension(uint a_uIndex)
+{
+	if (a_uIndex >= m_nDimensionCount)
+		return -1;
+	return m_DimensionArray[a_uIndex];
 }
 bool Simplex::MyEntity::SharesDimension(MyEntity* const a_pOther)
 {
@@ -220,18 +244,32 @@ bool Simplex::MyEntity::SharesDimension(MyEntity* const a_pOther)
 			return true;
 	}
 
-	//for each dimension on both Entities we check if there is a common dimension
-	for (uint i = 0; i < m_nDimensionCount; ++i)
+	if (0 == m_nDimensionCount || 0 == a_pOther->m_nDimensionCount)
+		return false;
+
+	//both sets are sorted, if their ranges do not meet there is nothing to walk
+	if (m_DimensionArray[m_nDimensionCount - 1] < a_pOther->m_DimensionArray[0] ||
+		a_pOther->m_DimensionArray[a_pOther->m_nDimensionCount - 1] < m_DimensionArray[0])
+		return false;
+
+	//otherwise walk them side by side looking for a common dimension
+	return GetFirstSharedDimension(a_pOther) >= 0;
+}
+int Simplex::MyEntity::GetFirstSharedDimension(MyEntity* const a_pOther)
+{
+	//both arrays are kept sorted so we can walk them side by side
+	uint i = 0;
+	uint j = 0;
+	while (i < m_nDimensionCount && j < a_pOther->m_nDimensionCount)
 	{
-		for (uint j = 0; j < a_pOther->m_nDimensionCount; j++)
-		{
-			if (m_DimensionArray[i] == a_pOther->m_DimensionArray[j])
-				return true; //as soon as we find one we know they share dimensionality
-		}
+		if (m_DimensionArray[i] == a_pOther->m_DimensionArray[j])
+			return static_cast<int>(m_DimensionArray[i]);
+		if (m_DimensionArray[i] < a_pOther->m_DimensionArray[j])
+			++i;
+		else
+			++j;
 	}
-
-	//could not find a common dimension
-	return false;
+	return -1;
 }
 bool Simplex::MyEntity::IsColliding(MyEntity* const other)
 {
@@ -16,9 +16,13 @@ class MyEntity
 	bool m_bInMemory = false; //loaded flag
 	bool m_bSetAxis = false; //render axis flag
 	String m_sUniqueID = ""; //Unique identifier name
+	uint m_uHandleSlot = static_cast<uint>(-1); //slot of the handle the Entity Manager gave this entity, -1 if it has none
 
+	static const uint m_uDimensionInline = 8; //dimensions that fit in the entity itself before going to the heap
 	uint m_nDimensionCount = 0; //tells how many dimensions this entity lives in
-	uint* m_DimensionArray = nullptr; //Dimensions on which this entity is located
+	uint m_nDimensionCapacity = m_uDimensionInline; //how many dimensions fit before the array grows
+	uint m_DimensionInline[m_uDimensionInline]; //storage of the dimensions while there are only a few
+	uint* m_DimensionArray = m_DimensionInline; //Dimensions on which this entity is located, sorted
 
 	Model* m_pModel = nullptr; //Model associated with this MyEntity
 	MyRigidBody* m_pRigidBody = nullptr; //Rigid Body associated with this MyEntity
@@ -28,6 +32,14 @@ class MyEntity
 
 	static std::map<String, MyEntity*> m_IDMap; //a map of the unique ID's
 
+	//what every entity made from the same file shares
+	struct ModelCacheEntry
+	{
+		Model* m_pModel = nullptr; //model loaded once for the file
+		std::vector<vector3> m_lBoundingPoint; //min and max of the model in local space
+	};
+	static std::map<String, ModelCacheEntry> m_ModelCache; //a map of the loaded files
+
 public:
 	/*
 	Usage: Constructor that specifies the name attached to the MyEntity
@@ -74,7 +86,8 @@ public:
 	*/
 	void SetModelMatrix(matrix4 a_m4ToWorld);
 	/*
-	USAGE: Gets the model associated with this entity
+	USAGE: Gets the model associated with this entity, shared by every entity loaded from
+	the same file
 	ARGUMENTS: ---
 	OUTPUT: Model
 	*/
@@ -122,6 +135,19 @@ public:
 	*/
 	String GetUniqueID(void);
 	/*
+	USAGE: Sets the slot of the handle the Entity Manager gave this entity, so the manager
+	can find its index without looking through its list
+	ARGUMENTS: uint a_uSlot -> slot of the handle, -1 if it has none
+	OUTPUT: ---
+	*/
+	void SetHandleSlot(uint a_uSlot);
+	/*
+	USAGE: Gets the slot of the handle the Entity Manager gave this entity
+	ARGUMENTS: ---
+	OUTPUT: slot of the handle, -1 if it has none
+	*/
+	uint GetHandleSlot(void);
+	/*
 	USAGE: Sets the visibility of the axis of this MyEntity
 	ARGUMENTS: bool a_bSetAxis = true -> axis visible?
 	OUTPUT: ---
@@ -152,11 +178,29 @@ public:
 	*/
 	bool IsInDimension(uint a_uDimension);
 	/*
+	USAGE: Gets the number of dimensions this entity lives in
+	ARGUMENTS: ---
+	OUTPUT: dimension count
+	*/
+	uint GetDimensionCount(void);
+	/*
+	USAGE: Gets the dimension specified by index, dimensions are kept sorted
+	ARGUMENTS: uint a_uIndex -> index in the dimension set
+	OUTPUT: dimension, -1 if out of bounds
+	*/
+	uint GetDimension(uint a_uIndex);
+	/*
 	USAGE: Asks if this entity shares a dimension with the incoming one
 	ARGUMENTS: MyEntity* const a_pOther -> queried entity
 	OUTPUT: shares at least one dimension?
 	*/
 	bool SharesDimension(MyEntity* const a_pOther);
+	/*
+	USAGE: Gets the lowest dimension this entity shares with the incoming one
+	ARGUMENTS: MyEntity* const a_pOther -> queried entity
+	OUTPUT: first shared dimension, -1 if they do not share any
+	*/
+	int GetFirstSharedDimension(MyEntity* const a_pOther);
 
 	/*
 	USAGE: Clears the collision list of this entity
@@ -180,6 +224,12 @@ private:
 	*/
 	void Release(void);
 	/*
+	Usage: Makes sure the dimension array can hold the specified number of dimensions
+	Arguments: uint a_uCapacity -> number of dimensions
+	Output: ---
+	*/
+	void ReserveDimensions(uint a_uCapacity);
+	/*
 	Usage: Allocates member fields
 	Arguments: ---
 	Output: ---
@@ -1,11 +1,48 @@
 #include "MyEntityManager.h"
+#include "MyOctant.h"
+#include "MyLinearOctree.h"
+#include "MyLooseOctree.h"
+#include "MyThreadPool.h"
 using namespace Simplex;
 //  MyEntityManager
 Simplex::MyEntityManager* Simplex::MyEntityManager::m_pInstance = nullptr;
 void Simplex::MyEntityManager::Init(void)
 {
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
+	m_eBroadPhase = BP_NONE;
+	m_pOctree = nullptr;
+	m_lMovedEntity.clear();
+	m_AABBStore.Clear();
+	m_pLinearOctree = nullptr;
+	m_pLooseOctree = nullptr;
+	m_lLooseEntity.clear();
+	m_lThreadCandidate.clear();
+	m_bParallel = false;
+	m_lLeafTask.clear();
+	m_lThreadPair.clear();
+	m_SweepAndPrune.Clear();
+	m_lSweepPair.clear();
+	m_DynamicTree.Clear();
+	m_lTreePair.clear();
+	m_SpatialHash.Clear();
+	m_lHashPair.clear();
+	m_lSlotEntity.clear();
+	m_lSlotGeneration.clear();
+	m_lFreeSlot.clear();
+	m_lEntitySlot.clear();
+	m_lBatchIndex.clear();
+	m_lBatchRigidBody.clear();
+	m_lBatchMatrix.clear();
+	m_lEntityVersion.clear();
+	m_lEntityDirty.clear();
+	m_lContact.clear();
+	m_lContactFound.clear();
+	m_lContactMerge.clear();
+	m_lContactBegin.clear();
+	m_lContactPersist.clear();
+	m_lContactEnd.clear();
 }
 void Simplex::MyEntityManager::Release(void)
 {
@@ -14,8 +51,29 @@ void Simplex::MyEntityManager::Release(void)
 		MyEntity* pEntity = m_mEntityArray[uEntity];
 		SafeDelete(pEntity);
 	}
+	if (m_mEntityArray)
+	{
+		delete[] m_mEntityArray;
+	}
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
+	m_AABBStore.Clear();
+	m_DynamicTree.Clear();
+	m_lSlotEntity.clear();
+	m_lSlotGeneration.clear();
+	m_lFreeSlot.clear();
+	m_lEntitySlot.clear();
+	m_lEntityVersion.clear();
+	m_lEntityDirty.clear();
+	m_lContact.clear();
+	m_lContactFound.clear();
+	m_lContactBegin.clear();
+	m_lContactPersist.clear();
+	m_lContactEnd.clear();
+	m_pOctree = nullptr;
+	m_pLinearOctree = nullptr;
+	m_pLooseOctree = nullptr;
 }
 Simplex::MyEntityManager* Simplex::MyEntityManager::GetInstance()
 {
@@ -35,14 +93,62 @@ void Simplex::MyEntityManager::ReleaseInstance()
 }
 int Simplex::MyEntityManager::GetEntityIndex(String a_sUniqueID)
 {
-	//look one by one for the specified unique id
-	for (uint uIndex = 0; uIndex < m_uEntityCount; ++uIndex)
+	//let the map of the entities find it, its handle slot tells where it is in the list
+	MyEntity* pTemp = MyEntity::GetEntity(a_sUniqueID);
+	if (pTemp == nullptr)
+		return -1;
+	uint uSlot = pTemp->GetHandleSlot();
+	if (uSlot >= m_lSlotEntity.size())
+		return -1;
+	uint uIndex = m_lSlotEntity[uSlot];
+	//an entity the manager does not own might carry a slot it was never given
+	if (uIndex >= m_uEntityCount || m_mEntityArray[uIndex] != pTemp)
+		return -1;
+	return static_cast<int>(uIndex);
+}
+int Simplex::MyEntityManager::GetEntityIndex(MyEntityHandle a_hEntity)
+{
+	//the slot has to exist and must not have been freed since the handle was given
+	if (a_hEntity.m_uSlot >= m_lSlotEntity.size())
+		return -1;
+	if (m_lSlotGeneration[a_hEntity.m_uSlot] != a_hEntity.m_uGeneration)
+		return -1;
+	return static_cast<int>(m_lSlotEntity[a_hEntity.m_uSlot]);
+}
+bool Simplex::MyEntityManager::IsValid(MyEntityHandle a_hEntity) { return GetEntityIndex(a_hEntity) >= 0; }
+Simplex::MyEntityHandle Simplex::MyEntityManager::GetHandle(uint a_uIndex)
+{
+	MyEntityHandle handle;
+	if (a_uIndex >= m_uEntityCount)
+		return handle;
+
+	handle.m_uSlot = m_lEntitySlot[a_uIndex];
+	handle.m_uGeneration = m_lSlotGeneration[handle.m_uSlot];
+	return handle;
+}
+Simplex::MyEntityHandle Simplex::MyEntityManager::AddHandle(void)
+{
+	//reuse a freed slot if there is one, its generation already tells old handles apart
+	uint uSlot = 0;
+	if (!m_lFreeSlot.empty())
 	{
-		if (a_sUniqueID == m_mEntityArray[uIndex]->GetUniqueID())
-			return uIndex;
+		uSlot = m_lFreeSlot.back();
+		m_lFreeSlot.pop_back();
 	}
-	//if not found return -1
-	return -1;
+	else
+	{
+		uSlot = static_cast<uint>(m_lSlotEntity.size());
+		m_lSlotEntity.push_back(0);
+		m_lSlotGeneration.push_back(0);
+	}
+	m_lSlotEntity[uSlot] = m_uEntityCount - 1;
+	m_lEntitySlot.push_back(uSlot);
+	m_mEntityArray[m_uEntityCount - 1]->SetHandleSlot(uSlot);
+
+	MyEntityHandle handle;
+	handle.m_uSlot = uSlot;
+	handle.m_uGeneration = m_lSlotGeneration[uSlot];
+	return handle;
 }
 //Accessors
 Simplex::uint Simplex::MyEntityManager::GetEntityCount(void) {	return m_uEntityCount; }
@@ -69,6 +175,15 @@ Simplex::Model* Simplex::MyEntityManager::GetModel(String a_sUniqueID)
 	}
 	return nullptr;
 }
+Simplex::Model* Simplex::MyEntityManager::GetModel(MyEntityHandle a_hEntity)
+{
+	//unlike an index out of bounds a stale handle does not fall back to the last entity
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return nullptr;
+
+	return m_mEntityArray[nIndex]->GetModel();
+}
 Simplex::MyRigidBody* Simplex::MyEntityManager::GetRigidBody(uint a_uIndex)
 {
 	//if the list is empty return
@@ -92,6 +207,14 @@ Simplex::MyRigidBody* Simplex::MyEntityManager::GetRigidBody(String a_sUniqueID)
 	}
 	return nullptr;
 }
+Simplex::MyRigidBody* Simplex::MyEntityManager::GetRigidBody(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return nullptr;
+
+	return m_mEntityArray[nIndex]->GetRigidBody();
+}
 Simplex::matrix4 Simplex::MyEntityManager::GetModelMatrix(uint a_uIndex)
 {
 	//if the list is empty return
@@ -115,6 +238,14 @@ Simplex::matrix4 Simplex::MyEntityManager::GetModelMatrix(String a_sUniqueID)
 	}
 	return IDENTITY_M4;
 }
+Simplex::matrix4 Simplex::MyEntityManager::GetModelMatrix(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return IDENTITY_M4;
+
+	return m_mEntityArray[nIndex]->GetModelMatrix();
+}
 void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, String a_sUniqueID)
 {
 	//Get the entity
@@ -122,9 +253,95 @@ void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, String a_sUni
 	//if the entity exists
 	if (pTemp)
 	{
+		MyRigidBody* pRigidBody = pTemp->GetRigidBody();
+		vector3 v3Min = pRigidBody->GetMinSwept();
+		vector3 v3Max = pRigidBody->GetMaxSwept();
+
 		pTemp->SetModelMatrix(a_m4ToWorld);
+
+		//if the global box changed the store and the octree need to know
+		if (v3Min != pRigidBody->GetMinSwept() || v3Max != pRigidBody->GetMaxSwept())
+		{
+			int nIndex = GetEntityIndex(a_sUniqueID);
+			if (nIndex >= 0)
+			{
+				m_AABBStore.Set(static_cast<uint>(nIndex), pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+				if (IsTrackingMoves())
+					m_lMovedEntity.push_back(static_cast<uint>(nIndex));
+			}
+		}
+	}
+}
+void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	SetModelMatrix(a_m4ToWorld, static_cast<uint>(nIndex));
+}
+void Simplex::MyEntityManager::SetModelMatrices(uint const* a_pIndex, matrix4 const* a_pToWorld, uint a_uCount)
+{
+	//gather the rigid bodies so all of their boxes are computed in one pass
+	m_lBatchIndex.clear();
+	m_lBatchRigidBody.clear();
+	m_lBatchMatrix.clear();
+	for (uint i = 0; i < a_uCount; ++i)
+	{
+		uint uIndex = a_pIndex[i];
+		if (uIndex >= m_uEntityCount || !m_mEntityArray[uIndex]->IsInitialized())
+			continue;
+		m_lBatchIndex.push_back(uIndex);
+		m_lBatchRigidBody.push_back(m_mEntityArray[uIndex]->GetRigidBody());
+		m_lBatchMatrix.push_back(a_pToWorld[i]);
+	}
+	MyRigidBody::SetModelMatrixBatch(m_lBatchRigidBody.data(), m_lBatchMatrix.data(), static_cast<uint>(m_lBatchIndex.size()));
+
+	for (uint i = 0; i < m_lBatchIndex.size(); ++i)
+	{
+		uint uIndex = m_lBatchIndex[i];
+		//the rigid body already has this matrix so the entity only keeps its copy
+		m_mEntityArray[uIndex]->SetModelMatrix(m_lBatchMatrix[i]);
+
+		//the store still has the old box, if it changed the store and the octree need to know
+		MyRigidBody* pRigidBody = m_lBatchRigidBody[i];
+		if (m_AABBStore.GetMin(uIndex) != pRigidBody->GetMinSwept() || m_AABBStore.GetMax(uIndex) != pRigidBody->GetMaxSwept())
+		{
+			m_AABBStore.Set(uIndex, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+			if (IsTrackingMoves())
+				m_lMovedEntity.push_back(uIndex);
+		}
+	}
+}
+void Simplex::MyEntityManager::SetContinuous(bool a_bContinuous, uint a_uIndex)
+{
+	//if the list is empty return
+	if (m_uEntityCount == 0)
+		return;
+
+	//if the index is larger than the number of entries we are asking for the last one
+	if (a_uIndex >= m_uEntityCount)
+		a_uIndex = m_uEntityCount - 1;
+
+	MyRigidBody* pRigidBody = m_mEntityArray[a_uIndex]->GetRigidBody();
+	pRigidBody->SetContinuous(a_bContinuous);
+
+	//the box swept so far is forgotten, the store might hold a larger one
+	if (m_AABBStore.GetMin(a_uIndex) != pRigidBody->GetMinSwept() || m_AABBStore.GetMax(a_uIndex) != pRigidBody->GetMaxSwept())
+	{
+		m_AABBStore.Set(a_uIndex, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		if (IsTrackingMoves())
+			m_lMovedEntity.push_back(a_uIndex);
 	}
 }
+void Simplex::MyEntityManager::SetContinuous(bool a_bContinuous, MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	SetContinuous(a_bContinuous, static_cast<uint>(nIndex));
+}
 void Simplex::MyEntityManager::SetAxisVisibility(bool a_bVisibility, uint a_uIndex)
 {
 	//if the list is empty return
@@ -147,6 +364,14 @@ void Simplex::MyEntityManager::SetAxisVisibility(bool a_bVisibility, String a_sU
 		pTemp->SetAxisVisible(a_bVisibility);
 	}
 }
+void Simplex::MyEntityManager::SetAxisVisibility(bool a_bVisibility, MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	m_mEntityArray[nIndex]->SetAxisVisible(a_bVisibility);
+}
 void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, uint a_uIndex)
 {
 	//if the list is empty return
@@ -157,7 +382,19 @@ void Simplex::MyEntityManager::SetModelMatrix(matrix4 a_m4ToWorld, uint a_uIndex
 	if (a_uIndex >= m_uEntityCount)
 		a_uIndex = m_uEntityCount - 1;
 
+	MyRigidBody* pRigidBody = m_mEntityArray[a_uIndex]->GetRigidBody();
+	vector3 v3Min = pRigidBody->GetMinSwept();
+	vector3 v3Max = pRigidBody->GetMaxSwept();
+
 	m_mEntityArray[a_uIndex]->SetModelMatrix(a_m4ToWorld);
+
+	//if the global box changed the store and the octree need to know
+	if (v3Min != pRigidBody->GetMinSwept() || v3Max != pRigidBody->GetMaxSwept())
+	{
+		m_AABBStore.Set(a_uIndex, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		if (IsTrackingMoves())
+			m_lMovedEntity.push_back(a_uIndex);
+	}
 }
 //The big 3
 Simplex::MyEntityManager::MyEntityManager(){Init();}
@@ -167,48 +404,575 @@ Simplex::MyEntityManager::~MyEntityManager(){Release();};
 // other methods
 void Simplex::MyEntityManager::Update(void)
 {
-	//Clear all collisions
+	//move the entities that changed to their new leafs before looking for pairs
+	if (m_eBroadPhase == BP_OCTREE && m_pOctree != nullptr)
+	{
+		RefreshOctree();
+	}
+	//the loose octree is asked even if nothing moved, it stores the entities added since the last update
+	else if (m_eBroadPhase == BP_LOOSE_OCTREE && m_pLooseOctree != nullptr)
+	{
+		m_pLooseOctree->UpdateEntities(m_lMovedEntity);
+	}
+	//the tree follows additions and removals as they happen, moves are applied here
+	else if (m_eBroadPhase == BP_DYNAMIC_TREE)
+	{
+		for (uint i = 0; i < m_lMovedEntity.size(); ++i)
+		{
+			uint uIndex = m_lMovedEntity[i];
+			if (uIndex < m_uEntityCount)
+				m_DynamicTree.Move(m_lEntitySlot[uIndex], m_AABBStore.GetMin(uIndex), m_AABBStore.GetMax(uIndex));
+		}
+	}
+	m_lMovedEntity.clear();
+
+	//the colliding lists are kept between updates, so a pair where neither rigid body
+	//changed keeps its last result and only the pairs with a changed body are tested
+	uint uDirtyCount = 0;
+	for (uint i = 0; i < m_uEntityCount; i++)
+	{
+		MyRigidBody* pRigidBody = m_mEntityArray[i]->GetRigidBody();
+		uint uVersion = pRigidBody->GetVersion();
+		m_lEntityDirty[i] = uVersion != m_lEntityVersion[i];
+		m_lEntityVersion[i] = uVersion;
+		if (m_lEntityDirty[i])
+		{
+			pRigidBody->DetachCollidingList();
+			++uDirtyCount;
+		}
+	}
+
+	//check collisions, with nothing changed only removals can end a contact
+	m_lContactFound.clear();
+	if (uDirtyCount > 0)
+	{
+		if (m_eBroadPhase == BP_OCTREE && m_pOctree != nullptr)
+			UpdateOctree();
+		else if (m_eBroadPhase == BP_LINEAR_OCTREE && m_pLinearOctree != nullptr)
+			UpdateLinearOctree();
+		else if (m_eBroadPhase == BP_SWEEP_AND_PRUNE)
+			UpdateSweepAndPrune();
+		else if (m_eBroadPhase == BP_LOOSE_OCTREE && m_pLooseOctree != nullptr)
+			UpdateLooseOctree();
+		else if (m_eBroadPhase == BP_DYNAMIC_TREE)
+			UpdateDynamicTree();
+		else if (m_eBroadPhase == BP_SPATIAL_HASH)
+			UpdateSpatialHash();
+		else
+			UpdateBruteForce();
+	}
+
+	UpdateContacts();
+
+	//the next moves of the continuous bodies are swept from where they are now
 	for (uint i = 0; i < m_uEntityCount; i++)
 	{
-		m_mEntityArray[i]->ClearCollisionList();
+		MyRigidBody* pRigidBody = m_mEntityArray[i]->GetRigidBody();
+		if (!pRigidBody->BeginStep())
+			continue;
+		m_AABBStore.Set(i, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		if (IsTrackingMoves())
+			m_lMovedEntity.push_back(i);
 	}
+}
+void Simplex::MyEntityManager::AddContact(uint a_uIndexA, uint a_uIndexB)
+{
+	if (m_lEntitySlot[a_uIndexB] < m_lEntitySlot[a_uIndexA])
+		std::swap(a_uIndexA, a_uIndexB);
+	MyContactPair contact;
+	contact.m_hEntityA = GetHandle(a_uIndexA);
+	contact.m_hEntityB = GetHandle(a_uIndexB);
+	//only the colliding pairs get here, so the full test of every axis is rarely run
+	uint uAxis = eSATResults::SAT_NONE;
+	m_mEntityArray[a_uIndexA]->GetRigidBody()->SATContact(m_mEntityArray[a_uIndexB]->GetRigidBody(),
+		uAxis, contact.m_fDepth, contact.m_v3Normal);
+	m_lContactFound.push_back(contact);
+}
+bool Simplex::MyEntityManager::IsContactLess(MyContactPair const& a_Left, MyContactPair const& a_Right)
+{
+	if (a_Left.m_hEntityA.m_uSlot != a_Right.m_hEntityA.m_uSlot)
+		return a_Left.m_hEntityA.m_uSlot < a_Right.m_hEntityA.m_uSlot;
+	if (a_Left.m_hEntityB.m_uSlot != a_Right.m_hEntityB.m_uSlot)
+		return a_Left.m_hEntityB.m_uSlot < a_Right.m_hEntityB.m_uSlot;
+	//a reused slot is a different entity, its pairs must not match the old ones
+	if (a_Left.m_hEntityA.m_uGeneration != a_Right.m_hEntityA.m_uGeneration)
+		return a_Left.m_hEntityA.m_uGeneration < a_Right.m_hEntityA.m_uGeneration;
+	return a_Left.m_hEntityB.m_uGeneration < a_Right.m_hEntityB.m_uGeneration;
+}
+void Simplex::MyEntityManager::UpdateContacts(void)
+{
+	m_lContactBegin.clear();
+	m_lContactPersist.clear();
+	m_lContactEnd.clear();
+	m_lContactMerge.clear();
 
-	//check collisions
-	for (uint i = 0; i < m_uEntityCount - 1; i++)
+	//both lists sorted, a single walk tells which pairs are new, kept or gone
+	std::sort(m_lContactFound.begin(), m_lContactFound.end(), IsContactLess);
+	uint uOld = 0;
+	uint uFound = 0;
+	while (uOld < m_lContact.size() || uFound < m_lContactFound.size())
 	{
-		for (uint j = i + 1; j < m_uEntityCount; j++)
+		if (uOld == m_lContact.size() || (uFound < m_lContactFound.size() && IsContactLess(m_lContactFound[uFound], m_lContact[uOld])))
+		{
+			m_lContactBegin.push_back(m_lContactFound[uFound]);
+			m_lContactMerge.push_back(m_lContactFound[uFound]);
+			++uFound;
+			continue;
+		}
+		MyContactPair const& contact = m_lContact[uOld];
+		++uOld;
+		if (uFound < m_lContactFound.size() && !IsContactLess(contact, m_lContactFound[uFound]))
+		{
+			//found again, the new depth replaces the old one
+			m_lContactPersist.push_back(m_lContactFound[uFound]);
+			m_lContactMerge.push_back(m_lContactFound[uFound]);
+			++uFound;
+			continue;
+		}
+		//not found again, it still holds if neither entity changed (so it was not tested)
+		int nIndexA = GetEntityIndex(contact.m_hEntityA);
+		int nIndexB = GetEntityIndex(contact.m_hEntityB);
+		if (nIndexA >= 0 && nIndexB >= 0 && !m_lEntityDirty[nIndexA] && !m_lEntityDirty[nIndexB])
+		{
+			m_lContactPersist.push_back(contact);
+			m_lContactMerge.push_back(contact);
+		}
+		else
 		{
-			m_mEntityArray[i]->IsColliding(m_mEntityArray[j]);
+			m_lContactEnd.push_back(contact);
 		}
 	}
+	std::swap(m_lContact, m_lContactMerge);
 }
-void Simplex::MyEntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
+std::vector<Simplex::MyContactPair> const& Simplex::MyEntityManager::GetContactList(void) { return m_lContact; }
+std::vector<Simplex::MyContactPair> const& Simplex::MyEntityManager::GetContactBegin(void) { return m_lContactBegin; }
+std::vector<Simplex::MyContactPair> const& Simplex::MyEntityManager::GetContactPersist(void) { return m_lContactPersist; }
+std::vector<Simplex::MyContactPair> const& Simplex::MyEntityManager::GetContactEnd(void) { return m_lContactEnd; }
+void Simplex::MyEntityManager::UpdateBruteForce(void)
+{
+	//the boxes are tested a batch at a time, only the overlapping pairs reach the entities
+	for (uint i = 0; i + 1 < m_uEntityCount; i++)
+	{
+		vector3 v3Min = m_AABBStore.GetMin(i);
+		vector3 v3Max = m_AABBStore.GetMax(i);
+		for (uint j = i + 1; j < m_uEntityCount; j += MyAABBStore::m_uBatch)
+		{
+			uint uMask = m_AABBStore.OverlapMask(v3Min, v3Max, j, m_uEntityCount - j);
+			for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+			{
+				if ((uMask & 1) == 0 || (!m_lEntityDirty[i] && !m_lEntityDirty[j + k]))
+					continue;
+				if (m_mEntityArray[i]->IsColliding(m_mEntityArray[j + k]))
+					AddContact(i, j + k);
+			}
+		}
+	}
+}
+void Simplex::MyEntityManager::UpdateOctree(void)
+{
+	uint uLeafCount = m_pOctree->GetLeafCount();
+	for (uint uLeaf = 0; uLeaf < uLeafCount; ++uLeaf)
+	{
+		uint uCount = m_pOctree->GetLeafEntityCount(uLeaf);
+		if (uCount < 2)
+			continue;
+		if (m_bParallel)
+			m_lLeafTask.push_back({ m_pOctree->GetLeafEntityList(uLeaf), uCount, static_cast<int>(m_pOctree->GetLeafID(uLeaf)) });
+		else
+			CheckLeafPairs(m_pOctree->GetLeafEntityList(uLeaf), uCount, static_cast<int>(m_pOctree->GetLeafID(uLeaf)));
+	}
+	if (m_bParallel)
+		UpdateLeafsParallel();
+}
+void Simplex::MyEntityManager::UpdateLinearOctree(void)
+{
+	uint uLeafCount = m_pLinearOctree->GetLeafCount();
+	for (uint uLeaf = 0; uLeaf < uLeafCount; ++uLeaf)
+	{
+		uint uCount = m_pLinearOctree->GetLeafEntityCount(uLeaf);
+		if (uCount < 2)
+			continue;
+		if (m_bParallel)
+			m_lLeafTask.push_back({ m_pLinearOctree->GetLeafEntityList(uLeaf), uCount, static_cast<int>(m_pLinearOctree->GetLeafID(uLeaf)) });
+		else
+			CheckLeafPairs(m_pLinearOctree->GetLeafEntityList(uLeaf), uCount, static_cast<int>(m_pLinearOctree->GetLeafID(uLeaf)));
+	}
+	if (m_bParallel)
+		UpdateLeafsParallel();
+}
+void Simplex::MyEntityManager::UpdateSweepAndPrune(void)
+{
+	m_lSweepPair.clear();
+	m_SweepAndPrune.Update(&m_AABBStore, m_lSweepPair);
+	for (uint i = 0; i + 1 < m_lSweepPair.size(); i += 2)
+	{
+		if (!m_lEntityDirty[m_lSweepPair[i]] && !m_lEntityDirty[m_lSweepPair[i + 1]])
+			continue;
+		MyRigidBody* pRigidBody = m_mEntityArray[m_lSweepPair[i]]->GetRigidBody();
+		if (pRigidBody->IsColliding(m_mEntityArray[m_lSweepPair[i + 1]]->GetRigidBody()))
+			AddContact(m_lSweepPair[i], m_lSweepPair[i + 1]);
+	}
+}
+void Simplex::MyEntityManager::UpdateSpatialHash(void)
+{
+	m_lHashPair.clear();
+	m_SpatialHash.Update(&m_AABBStore, m_lHashPair);
+	for (uint i = 0; i + 1 < m_lHashPair.size(); i += 2)
+	{
+		if (!m_lEntityDirty[m_lHashPair[i]] && !m_lEntityDirty[m_lHashPair[i + 1]])
+			continue;
+		MyRigidBody* pRigidBody = m_mEntityArray[m_lHashPair[i]]->GetRigidBody();
+		if (pRigidBody->IsColliding(m_mEntityArray[m_lHashPair[i + 1]]->GetRigidBody()))
+			AddContact(m_lHashPair[i], m_lHashPair[i + 1]);
+	}
+}
+void Simplex::MyEntityManager::UpdateDynamicTree(void)
+{
+	//the descent skips the subtrees without a changed entity
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		if (m_lEntityDirty[i])
+			m_DynamicTree.SetDirty(m_lEntitySlot[i]);
+	}
+	m_lTreePair.clear();
+	m_DynamicTree.ComputePairs(m_lTreePair);
+
+	for (uint i = 0; i + 1 < m_lTreePair.size(); i += 2)
+	{
+		uint uIndexA = m_lSlotEntity[m_lTreePair[i]];
+		uint uIndexB = m_lSlotEntity[m_lTreePair[i + 1]];
+		//the leafs are fattened, the real boxes might still be apart
+		vector3 v3Min = m_AABBStore.GetMin(uIndexA);
+		vector3 v3Max = m_AABBStore.GetMax(uIndexA);
+		if (m_AABBStore.OverlapMask(v3Min, v3Max, &uIndexB, 1) == 0)
+			continue;
+		MyRigidBody* pRigidBody = m_mEntityArray[uIndexA]->GetRigidBody();
+		if (pRigidBody->IsColliding(m_mEntityArray[uIndexB]->GetRigidBody()))
+			AddContact(uIndexA, uIndexB);
+	}
+}
+void Simplex::MyEntityManager::RebuildDynamicTree(void)
+{
+	m_DynamicTree.Clear();
+	for (uint i = 0; i < m_uEntityCount; ++i)
+		m_DynamicTree.Insert(m_lEntitySlot[i], m_AABBStore.GetMin(i), m_AABBStore.GetMax(i));
+}
+void Simplex::MyEntityManager::UpdateLooseOctree(void)
+{
+	//a clean entity is found by the changed ones it overlaps, so only those ask the tree
+	m_lLooseEntity.clear();
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		if (m_lEntityDirty[i])
+			m_lLooseEntity.push_back(i);
+	}
+
+	if (!m_bParallel)
+	{
+		if (m_lThreadCandidate.size() < 1)
+			m_lThreadCandidate.resize(1);
+		for (uint i = 0; i < m_lLooseEntity.size(); ++i)
+			CheckLoosePairs(m_lLooseEntity[i], m_lThreadCandidate[0]);
+		return;
+	}
+
+	ClearThreadPairs();
+	if (m_lThreadCandidate.size() < m_lThreadPair.size())
+		m_lThreadCandidate.resize(m_lThreadPair.size());
+
+	//the queries only read the tree, each thread writes to its own lists
+	MyThreadPool::GetInstance()->ParallelFor(m_lLooseEntity.size(), [this](uint a_uTask, uint a_uThread)
+	{
+		CheckLoosePairs(m_lLooseEntity[a_uTask], m_lThreadCandidate[a_uThread], &m_lThreadPair[a_uThread]);
+	});
+	AddThreadPairs();
+}
+void Simplex::MyEntityManager::CheckLoosePairs(uint a_uEntity, std::vector<uint>& a_lCandidate, std::vector<uint>* a_pPairList)
+{
+	vector3 v3Min = m_AABBStore.GetMin(a_uEntity);
+	vector3 v3Max = m_AABBStore.GetMax(a_uEntity);
+	a_lCandidate.clear();
+	m_pLooseOctree->GetCandidates(v3Min, v3Max, a_lCandidate);
+
+	MyRigidBody* pRigidBody = m_mEntityArray[a_uEntity]->GetRigidBody();
+	uint uCount = static_cast<uint>(a_lCandidate.size());
+	for (uint j = 0; j < uCount; j += MyAABBStore::m_uBatch)
+	{
+		uint uMask = m_AABBStore.OverlapMask(v3Min, v3Max, a_lCandidate.data() + j, uCount - j);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+		{
+			if ((uMask & 1) == 0)
+				continue;
+			uint uOther = a_lCandidate[j + k];
+			//when both changed the pair is checked from the lower index only
+			if (uOther == a_uEntity || (m_lEntityDirty[uOther] && uOther < a_uEntity))
+				continue;
+			MyRigidBody* pOther = m_mEntityArray[uOther]->GetRigidBody();
+			if (a_pPairList == nullptr)
+			{
+				if (pRigidBody->IsColliding(pOther))
+					AddContact(a_uEntity, uOther);
+			}
+			else
+			{
+				uint uAxis = eSATResults::SAT_NONE;
+				if (pRigidBody->TestCollision(pOther, &uAxis) || uAxis != eSATResults::SAT_NONE)
+				{
+					a_pPairList->push_back(a_uEntity);
+					a_pPairList->push_back(uOther);
+					a_pPairList->push_back(uAxis);
+				}
+			}
+		}
+	}
+}
+void Simplex::MyEntityManager::UpdateLeafsParallel(void)
+{
+	ClearThreadPairs();
+
+	//the tests only read the entities, each thread writes to its own list
+	MyThreadPool::GetInstance()->ParallelFor(m_lLeafTask.size(), [this](uint a_uTask, uint a_uThread)
+	{
+		LeafTask& task = m_lLeafTask[a_uTask];
+		CheckLeafPairs(task.m_pEntity, task.m_uCount, task.m_nLeafID, &m_lThreadPair[a_uThread]);
+	});
+	m_lLeafTask.clear();
+	AddThreadPairs();
+}
+void Simplex::MyEntityManager::ClearThreadPairs(void)
+{
+	uint uThreadCount = MyThreadPool::GetInstance()->GetThreadCount();
+	if (m_lThreadPair.size() < uThreadCount)
+		m_lThreadPair.resize(uThreadCount);
+	for (uint i = 0; i < m_lThreadPair.size(); ++i)
+		m_lThreadPair[i].clear();
+}
+void Simplex::MyEntityManager::AddThreadPairs(void)
+{
+	//AddCollisionWith and SetSeparatingAxis change both bodies so they only run here
+	for (uint i = 0; i < m_lThreadPair.size(); ++i)
+	{
+		std::vector<uint>& lPair = m_lThreadPair[i];
+		for (uint j = 0; j + 2 < lPair.size(); j += 3)
+		{
+			MyRigidBody* pRigidBody = m_mEntityArray[lPair[j]]->GetRigidBody();
+			MyRigidBody* pOther = m_mEntityArray[lPair[j + 1]]->GetRigidBody();
+			pRigidBody->SetSeparatingAxis(pOther, lPair[j + 2]);
+			if (lPair[j + 2] != eSATResults::SAT_NONE)
+				continue;
+			pRigidBody->AddCollisionWith(pOther);
+			pOther->AddCollisionWith(pRigidBody);
+			AddContact(lPair[j], lPair[j + 1]);
+		}
+	}
+}
+void Simplex::MyEntityManager::CheckLeafPairs(uint const* a_pEntity, uint a_uCount, int a_nLeafID, std::vector<uint>* a_pPairList)
+{
+	for (uint i = 0; i + 1 < a_uCount; ++i)
+	{
+		MyEntity* pEntity = m_mEntityArray[a_pEntity[i]];
+		bool bDirty = m_lEntityDirty[a_pEntity[i]];
+		vector3 v3Min = m_AABBStore.GetMin(a_pEntity[i]);
+		vector3 v3Max = m_AABBStore.GetMax(a_pEntity[i]);
+		for (uint j = i + 1; j < a_uCount; j += MyAABBStore::m_uBatch)
+		{
+			uint uMask = m_AABBStore.OverlapMask(v3Min, v3Max, a_pEntity + j, a_uCount - j);
+			for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+			{
+				if ((uMask & 1) == 0)
+					continue;
+				uint uOther = a_pEntity[j + k];
+				//neither changed, the pair is still what the last update found
+				if (!bDirty && !m_lEntityDirty[uOther])
+					continue;
+				MyEntity* pOther = m_mEntityArray[uOther];
+				//a pair that spans several leaves is only checked in the first leaf they share
+				if (pEntity->GetFirstSharedDimension(pOther) != a_nLeafID)
+					continue;
+				if (a_pPairList == nullptr)
+				{
+					if (pEntity->GetRigidBody()->IsColliding(pOther->GetRigidBody()))
+						AddContact(a_pEntity[i], uOther);
+				}
+				else
+				{
+					uint uAxis = eSATResults::SAT_NONE;
+					if (pEntity->GetRigidBody()->TestCollision(pOther->GetRigidBody(), &uAxis) || uAxis != eSATResults::SAT_NONE)
+					{
+						a_pPairList->push_back(a_pEntity[i]);
+						a_pPairList->push_back(uOther);
+						a_pPairList->push_back(uAxis);
+					}
+				}
+			}
+		}
+	}
+}
+void Simplex::MyEntityManager::SetOctree(MyOctant* a_pRoot)
+{
+	//a new tree is built from the current positions, nothing is pending for it
+	m_pOctree = a_pRoot;
+	m_lMovedEntity.clear();
+	InvalidatePairCache();
+}
+MyOctant* Simplex::MyEntityManager::GetOctree(void) { return m_pOctree; }
+void Simplex::MyEntityManager::RefreshOctree(void)
+{
+	if (m_eBroadPhase != BP_OCTREE || m_pOctree == nullptr || m_lMovedEntity.size() == 0)
+		return;
+	m_pOctree->UpdateEntities(m_lMovedEntity);
+	m_lMovedEntity.clear();
+}
+void Simplex::MyEntityManager::SetLooseOctree(MyLooseOctree* a_pTree)
+{
+	//same as the octree, the tree is expected to match the current positions
+	m_pLooseOctree = a_pTree;
+	m_lMovedEntity.clear();
+	InvalidatePairCache();
+}
+bool Simplex::MyEntityManager::IsTrackingMoves(void)
+{
+	return (m_eBroadPhase == BP_OCTREE && m_pOctree != nullptr) || (m_eBroadPhase == BP_LOOSE_OCTREE && m_pLooseOctree != nullptr) ||
+		m_eBroadPhase == BP_DYNAMIC_TREE;
+}
+void Simplex::MyEntityManager::InvalidatePairCache(void)
+{
+	//no rigid body is given this version until the clock wraps around
+	std::fill(m_lEntityVersion.begin(), m_lEntityVersion.end(), static_cast<uint>(-1));
+}
+Simplex::MyAABBStore* Simplex::MyEntityManager::GetAABBStore(void) { return &m_AABBStore; }
+Simplex::MyDynamicTree* Simplex::MyEntityManager::GetDynamicTree(void) { return &m_DynamicTree; }
+Simplex::MySpatialHash* Simplex::MyEntityManager::GetSpatialHash(void) { return &m_SpatialHash; }
+void Simplex::MyEntityManager::SetLinearOctree(MyLinearOctree* a_pTree) { m_pLinearOctree = a_pTree; }
+void Simplex::MyEntityManager::SetParallel(bool a_bParallel) { m_bParallel = a_bParallel; }
+bool Simplex::MyEntityManager::GetParallel(void) { return m_bParallel; }
+void Simplex::MyEntityManager::SetBroadPhase(eBroadPhase a_eBroadPhase)
+{
+	//moves are only tracked for the trees, whoever switches to the loose octree has to rebuild it
+	bool bWasOctree = m_eBroadPhase == BP_OCTREE;
+	m_eBroadPhase = a_eBroadPhase;
+	m_lMovedEntity.clear();
+	//the octree stopped following the entities while not in use, and the other phases might
+	//have taken the dimensions its leafs are tagged with
+	if (m_eBroadPhase == BP_OCTREE && !bWasOctree && m_pOctree != nullptr)
+		m_pOctree->ConstructTree(m_pOctree->GetMaxLevel());
+	//the phases that do not use octants must not be filtered by the leafs of the last tree
+	if (m_eBroadPhase == BP_NONE || m_eBroadPhase == BP_SWEEP_AND_PRUNE || m_eBroadPhase == BP_LOOSE_OCTREE || m_eBroadPhase == BP_DYNAMIC_TREE ||
+		m_eBroadPhase == BP_SPATIAL_HASH)
+		ClearDimensionSetAll();
+	//the dynamic tree belongs to the manager, it stopped following the entities while not in use
+	if (m_eBroadPhase == BP_DYNAMIC_TREE)
+		RebuildDynamicTree();
+	//the dimensions the pairs were filtered by belong to the old broad phase
+	InvalidatePairCache();
+}
+Simplex::eBroadPhase Simplex::MyEntityManager::GetBroadPhase(void) { return m_eBroadPhase; }
+Simplex::String Simplex::MyEntityManager::GetBroadPhaseName(void)
+{
+	switch (m_eBroadPhase)
+	{
+	case BP_OCTREE:
+		return "Octree";
+	case BP_LINEAR_OCTREE:
+		return "Linear Octree";
+	case BP_SWEEP_AND_PRUNE:
+		return "Sweep and Prune";
+	case BP_LOOSE_OCTREE:
+		return "Loose Octree";
+	case BP_DYNAMIC_TREE:
+		return "Dynamic AABB Tree";
+	case BP_SPATIAL_HASH:
+		return "Spatial Hash";
+	default:
+		return "None";
+	}
+}
+Simplex::MyEntityHandle Simplex::MyEntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
 {
 	//Create a temporal entity to store the object
 	MyEntity* pTemp = new MyEntity(a_sFileName, a_sUniqueID);
 	//if I was able to generate it add it to the list
 	if (pTemp->IsInitialized())
 	{
-		//create a new temp array with one extra entry
-		PEntity* tempArray = new PEntity[m_uEntityCount + 1];
-		//start from 0 to the current count
-		uint uCount = 0;
-		for (uint i = 0; i < m_uEntityCount; ++i)
+		//double the list when full so adding N entities copies O(N) pointers
+		if (m_uEntityCount == m_uEntityCapacity)
 		{
-			tempArray[uCount] = m_mEntityArray[i];
-			++uCount;
+			Reserve(m_uEntityCapacity > 0 ? m_uEntityCapacity * 2 : 16);
 		}
-		tempArray[uCount] = pTemp;
-		//if there was an older array delete
-		if (m_mEntityArray)
+		m_mEntityArray[m_uEntityCount] = pTemp;
+		//add one entity to the count
+		++m_uEntityCount;
+
+		MyRigidBody* pRigidBody = pTemp->GetRigidBody();
+		m_AABBStore.Add(pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		m_lEntityVersion.push_back(static_cast<uint>(-1));
+		m_lEntityDirty.push_back(true);
+		MyEntityHandle handle = AddHandle();
+		if (m_eBroadPhase == BP_DYNAMIC_TREE)
+			m_DynamicTree.Insert(handle.m_uSlot, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		//the octrees place it in their octants with the moves of the next update
+		else if (IsTrackingMoves())
+			m_lMovedEntity.push_back(m_uEntityCount - 1);
+		return handle;
+	}
+	SafeDelete(pTemp);
+	return MyEntityHandle();
+}
+void Simplex::MyEntityManager::AddEntities(std::vector<MyEntityRecord> const& a_lRecord, std::vector<MyEntityHandle>* a_pHandleList)
+{
+	//grow once for the whole list
+	if (m_uEntityCount + a_lRecord.size() > m_uEntityCapacity)
+	{
+		Reserve(std::max(m_uEntityCount + static_cast<uint>(a_lRecord.size()), m_uEntityCapacity * 2));
+	}
+	for (uint i = 0; i < a_lRecord.size(); ++i)
+	{
+		MyEntityRecord const& record = a_lRecord[i];
+		MyEntity* pTemp = new MyEntity(record.m_sFileName, record.m_sUniqueID);
+		if (!pTemp->IsInitialized())
 		{
-			delete[] m_mEntityArray;
+			SafeDelete(pTemp);
+			if (a_pHandleList)
+				a_pHandleList->push_back(MyEntityHandle());
+			continue;
 		}
-		//make the member pointer the temp pointer
-		m_mEntityArray = tempArray;
-		//add one entity to the count
+		pTemp->SetModelMatrix(record.m_m4ToWorld);
+		m_mEntityArray[m_uEntityCount] = pTemp;
 		++m_uEntityCount;
+
+		MyRigidBody* pRigidBody = pTemp->GetRigidBody();
+		m_AABBStore.Add(pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		m_lEntityVersion.push_back(static_cast<uint>(-1));
+		m_lEntityDirty.push_back(true);
+
+		MyEntityHandle handle = AddHandle();
+		if (m_eBroadPhase == BP_DYNAMIC_TREE)
+			m_DynamicTree.Insert(handle.m_uSlot, pRigidBody->GetMinSwept(), pRigidBody->GetMaxSwept());
+		else if (IsTrackingMoves())
+			m_lMovedEntity.push_back(m_uEntityCount - 1);
+		if (a_pHandleList)
+			a_pHandleList->push_back(handle);
+	}
+}
+void Simplex::MyEntityManager::Reserve(uint a_uCapacity)
+{
+	if (a_uCapacity <= m_uEntityCapacity)
+		return;
+
+	//create a new array with room for the requested entries
+	PEntity* tempArray = new PEntity[a_uCapacity];
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		tempArray[i] = m_mEntityArray[i];
 	}
+	//if there was an older array delete
+	if (m_mEntityArray)
+	{
+		delete[] m_mEntityArray;
+	}
+	//make the member pointer the temp pointer
+	m_mEntityArray = tempArray;
+	m_uEntityCapacity = a_uCapacity;
 }
 void Simplex::MyEntityManager::RemoveEntity(uint a_uIndex)
 {
@@ -220,35 +984,72 @@ void Simplex::MyEntityManager::RemoveEntity(uint a_uIndex)
 	if (a_uIndex >= m_uEntityCount)
 		a_uIndex = m_uEntityCount - 1;
 
+	//the others must not keep pointing to the rigid body about to be deleted
+	m_mEntityArray[a_uIndex]->GetRigidBody()->DetachCollidingList();
+
+	//the octrees hold indices, they follow the swap below while the dimensions of both
+	//entities (or the octants they are stored in) still tell where they are
+	if (m_eBroadPhase == BP_OCTREE && m_pOctree != nullptr)
+		m_pOctree->RemoveEntity(a_uIndex);
+	else if (m_eBroadPhase == BP_LOOSE_OCTREE && m_pLooseOctree != nullptr)
+		m_pLooseOctree->RemoveEntity(a_uIndex);
+
+	//pending moves of the removed entity are dropped, those of the last one follow it
+	uint uLast = m_uEntityCount - 1;
+	uint uMoved = 0;
+	for (uint i = 0; i < m_lMovedEntity.size(); ++i)
+	{
+		if (m_lMovedEntity[i] == a_uIndex)
+			continue;
+		m_lMovedEntity[uMoved++] = m_lMovedEntity[i] == uLast ? a_uIndex : m_lMovedEntity[i];
+	}
+	m_lMovedEntity.resize(uMoved);
+
+	//free the handle slot of the entity, the handles that point to it go stale
+	uint uSlot = m_lEntitySlot[a_uIndex];
+	m_DynamicTree.Remove(uSlot);
+	m_lSlotEntity[uSlot] = static_cast<uint>(-1);
+	++m_lSlotGeneration[uSlot];
+	m_lFreeSlot.push_back(uSlot);
+
 	// if the entity is not the very last we swap it for the last one
 	if (a_uIndex != m_uEntityCount - 1)
 	{
 		std::swap(m_mEntityArray[a_uIndex], m_mEntityArray[m_uEntityCount - 1]);
+		//the handles of the moved entity keep working through its slot
+		m_lEntitySlot[a_uIndex] = m_lEntitySlot[m_uEntityCount - 1];
+		m_lSlotEntity[m_lEntitySlot[a_uIndex]] = a_uIndex;
+		m_lEntityVersion[a_uIndex] = m_lEntityVersion.back();
+		m_lEntityDirty[a_uIndex] = m_lEntityDirty.back();
 	}
+	m_lEntitySlot.pop_back();
+	m_lEntityVersion.pop_back();
+	m_lEntityDirty.pop_back();
 	
-	//and then pop the last one
-	//create a new temp array with one less entry
-	PEntity* tempArray = new PEntity[m_uEntityCount - 1];
-	//start from 0 to the current count
-	for (uint i = 0; i < m_uEntityCount - 1; ++i)
-	{
-		tempArray[i] = m_mEntityArray[i];
-	}
-	//if there was an older array delete
-	if (m_mEntityArray)
-	{
-		delete[] m_mEntityArray;
-	}
-	//make the member pointer the temp pointer
-	m_mEntityArray = tempArray;
-	//add one entity to the count
+	//and then pop the last one, the list keeps its capacity
+	SafeDelete(m_mEntityArray[m_uEntityCount - 1]);
+	//remove one entity from the count
 	--m_uEntityCount;
+
+	//the box store follows the same swap and pop
+	m_AABBStore.Remove(a_uIndex);
 }
 void Simplex::MyEntityManager::RemoveEntity(String a_sUniqueID)
 {
 	int nIndex = GetEntityIndex(a_sUniqueID);
+	//an unknown id would otherwise remove the last entity
+	if (nIndex < 0)
+		return;
 	RemoveEntity((uint)nIndex);
 }
+void Simplex::MyEntityManager::RemoveEntity(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	RemoveEntity(static_cast<uint>(nIndex));
+}
 Simplex::String Simplex::MyEntityManager::GetUniqueID(uint a_uIndex)
 {
 	//if the list is empty return
@@ -273,6 +1074,22 @@ Simplex::MyEntity* Simplex::MyEntityManager::GetEntity(uint a_uIndex)
 
 	return m_mEntityArray[a_uIndex];
 }
+Simplex::String Simplex::MyEntityManager::GetUniqueID(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return "";
+
+	return m_mEntityArray[nIndex]->GetUniqueID();
+}
+Simplex::MyEntity* Simplex::MyEntityManager::GetEntity(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return nullptr;
+
+	return m_mEntityArray[nIndex];
+}
 void Simplex::MyEntityManager::AddEntityToRenderList(uint a_uIndex, bool a_bRigidBody)
 {
 	//if out of bounds will do it for all
@@ -299,6 +1116,15 @@ void Simplex::MyEntityManager::AddEntityToRenderList(String a_sUniqueID, bool a_
 		pTemp->AddToRenderList(a_bRigidBody);
 	}
 }
+void Simplex::MyEntityManager::AddEntityToRenderList(MyEntityHandle a_hEntity, bool a_bRigidBody)
+{
+	//a stale handle adds nothing, it does not add all like an index out of bounds
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	m_mEntityArray[nIndex]->AddToRenderList(a_bRigidBody);
+}
 void Simplex::MyEntityManager::AddDimension(uint a_uIndex, uint a_uDimension)
 {
 	//if the list is empty return
@@ -321,6 +1147,14 @@ void Simplex::MyEntityManager::AddDimension(String a_sUniqueID, uint a_uDimensio
 		pTemp->AddDimension(a_uDimension);
 	}
 }
+void Simplex::MyEntityManager::AddDimension(MyEntityHandle a_hEntity, uint a_uDimension)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	m_mEntityArray[nIndex]->AddDimension(a_uDimension);
+}
 void Simplex::MyEntityManager::RemoveDimension(uint a_uIndex, uint a_uDimension)
 {
 	//if the list is empty return
@@ -343,6 +1177,14 @@ void Simplex::MyEntityManager::RemoveDimension(String a_sUniqueID, uint a_uDimen
 		pTemp->RemoveDimension(a_uDimension);
 	}
 }
+void Simplex::MyEntityManager::RemoveDimension(MyEntityHandle a_hEntity, uint a_uDimension)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	m_mEntityArray[nIndex]->RemoveDimension(a_uDimension);
+}
 void Simplex::MyEntityManager::ClearDimensionSetAll(void)
 {
 	for (uint i = 0; i < m_uEntityCount; ++i)
@@ -372,6 +1214,14 @@ void Simplex::MyEntityManager::ClearDimensionSet(String a_sUniqueID)
 		pTemp->ClearDimensionSet();
 	}
 }
+void Simplex::MyEntityManager::ClearDimensionSet(MyEntityHandle a_hEntity)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return;
+
+	m_mEntityArray[nIndex]->ClearDimensionSet();
+}
 bool Simplex::MyEntityManager::IsInDimension(uint a_uIndex, uint a_uDimension)
 {
 	//if the list is empty return
@@ -395,6 +1245,14 @@ bool Simplex::MyEntityManager::IsInDimension(String a_sUniqueID, uint a_uDimensi
 	}
 	return false;
 }
+bool Simplex::MyEntityManager::IsInDimension(MyEntityHandle a_hEntity, uint a_uDimension)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return false;
+
+	return m_mEntityArray[nIndex]->IsInDimension(a_uDimension);
+}
 bool Simplex::MyEntityManager::SharesDimension(uint a_uIndex, MyEntity* const a_pOther)
 {
 	//if the list is empty return
@@ -417,4 +1275,12 @@ bool Simplex::MyEntityManager::SharesDimension(String a_sUniqueID, MyEntity* con
 		return pTemp->SharesDimension(a_pOther);
 	}
 	return false;
+}
+bool Simplex::MyEntityManager::SharesDimension(MyEntityHandle a_hEntity, MyEntity* const a_pOther)
+{
+	int nIndex = GetEntityIndex(a_hEntity);
+	if (nIndex < 0)
+		return false;
+
+	return m_mEntityArray[nIndex]->SharesDimension(a_pOther);
 }
\ No newline at end of file
@@ -6,17 +6,111 @@ Date: 2017/07
 #define __MYENTITYMANAGER_H_
 
 #include "MyEntity.h"
+#include "MyAABBStore.h"
+#include "MySweepAndPrune.h"
+#include "MyDynamicTree.h"
+#include "MySpatialHash.h"
+
+class MyOctant; //octree used as broad phase (lives outside of the Simplex namespace)
+class MyLinearOctree; //Morton code octree used as broad phase (lives outside of the Simplex namespace)
+class MyLooseOctree; //loose octree used as broad phase (lives outside of the Simplex namespace)
 
 namespace Simplex
 {
 
+//Broad phase used by the manager to find the pairs of entities worth testing
+enum eBroadPhase
+{
+	BP_NONE = 0, //every pair of entities is tested (only filtered by dimension)
+	BP_OCTREE, //only the pairs that live in the same leaf of the octree are tested
+	BP_LINEAR_OCTREE, //only the pairs that live in the same leaf of the linear octree are tested
+	BP_SWEEP_AND_PRUNE, //only the pairs whose boxes overlap along the sorted axis are tested
+	BP_LOOSE_OCTREE, //each entity lives in one octant of the loose octree and is tested against the octants its box reaches
+	BP_DYNAMIC_TREE, //only the pairs whose fattened boxes overlap in the bounding volume hierarchy are tested
+	BP_SPATIAL_HASH, //only the pairs whose boxes overlap in a cell of the hashed grid are tested
+};
+
+//Stable reference to an entity, stays valid while the entity lives no matter how the list
+//is reordered and goes stale (instead of pointing to another entity) once it is removed
+struct MyEntityHandle
+{
+	uint m_uSlot = static_cast<uint>(-1); //slot of the handle table the entity was given
+	uint m_uGeneration = 0; //times the slot had been reused when the handle was given
+};
+
+//Two entities whose rigid bodies are colliding, the one with the lower handle slot goes first
+struct MyContactPair
+{
+	MyEntityHandle m_hEntityA; //entity with the lower handle slot
+	MyEntityHandle m_hEntityB; //entity with the higher handle slot
+	float m_fDepth = 0.0f; //how far the oriented boxes penetrate, 0 if they only met during a continuous move
+	vector3 m_v3Normal = ZERO_V3; //unit axis they penetrate the least along (or that separates them), from A to B
+};
+
+//Description of an entity to create in bulk with AddEntities
+struct MyEntityRecord
+{
+	String m_sFileName = ""; //Name of the model to load
+	String m_sUniqueID = "NA"; //Name wanted as identifier, if not available will generate one
+	matrix4 m_m4ToWorld = IDENTITY_M4; //Model matrix of the new entity
+};
+
 //System Class
 class MyEntityManager
 {
 	typedef MyEntity* PEntity; //MyEntity Pointer
 	uint m_uEntityCount = 0; //number of elements in the list
+	uint m_uEntityCapacity = 0; //number of elements the list can hold before growing
 	PEntity* m_mEntityArray = nullptr; //array of MyEntity pointers
 	static MyEntityManager* m_pInstance; // Singleton pointer
+
+	eBroadPhase m_eBroadPhase = BP_NONE; //broad phase used in Update
+	MyOctant* m_pOctree = nullptr; //root of the octree used by the BP_OCTREE broad phase
+	std::vector<uint> m_lMovedEntity; //entities whose global box changed since the octree (or the loose octree) last saw them
+	MyAABBStore m_AABBStore; //global box of every entity, same order as the entity list
+	MyLinearOctree* m_pLinearOctree = nullptr; //linear octree used by the BP_LINEAR_OCTREE broad phase
+	MyLooseOctree* m_pLooseOctree = nullptr; //loose octree used by the BP_LOOSE_OCTREE broad phase
+	std::vector<uint> m_lLooseEntity; //entities that look for pairs in the loose octree this update
+	std::vector<std::vector<uint>> m_lThreadCandidate; //entities the loose octree gave each thread for its current entity
+
+	//entities of a leaf waiting to be checked by the worker threads
+	struct LeafTask
+	{
+		uint const* m_pEntity; //index of the entities in the leaf
+		uint m_uCount; //number of entities in the leaf
+		int m_nLeafID; //ID of the leaf
+	};
+	bool m_bParallel = false; //are the leafs of the octrees checked by several threads?
+	std::vector<LeafTask> m_lLeafTask; //leafs to check in parallel this update
+	std::vector<std::vector<uint>> m_lThreadPair; //pairs tested by each thread, two indices and the separating axis (SAT_NONE if colliding) per pair
+
+	MySweepAndPrune m_SweepAndPrune; //sorted boxes used by the BP_SWEEP_AND_PRUNE broad phase
+	std::vector<uint> m_lSweepPair; //pairs found by the last sweep, two indices per pair
+
+	MyDynamicTree m_DynamicTree; //hierarchy used by the BP_DYNAMIC_TREE broad phase, keyed by handle slot
+	std::vector<uint> m_lTreePair; //pairs found by the last descent of the tree, two handle slots per pair
+
+	MySpatialHash m_SpatialHash; //hashed grid used by the BP_SPATIAL_HASH broad phase
+	std::vector<uint> m_lHashPair; //pairs found by the last binning, two indices per pair
+
+	std::vector<uint> m_lEntityVersion; //version of each rigid body seen by the last update, same order as the entity list
+	std::vector<bool> m_lEntityDirty; //did the rigid body of each entity change before the last update?
+
+	std::vector<MyContactPair> m_lContact; //pairs colliding after the last update, sorted by handle
+	std::vector<MyContactPair> m_lContactFound; //pairs the narrow phase found colliding this update
+	std::vector<MyContactPair> m_lContactMerge; //scratch list the new contact set is merged into
+	std::vector<MyContactPair> m_lContactBegin; //pairs that started colliding in the last update
+	std::vector<MyContactPair> m_lContactPersist; //pairs that kept colliding in the last update
+	std::vector<MyContactPair> m_lContactEnd; //pairs that stopped colliding in the last update
+
+	std::vector<uint> m_lBatchIndex; //entities updated by the last SetModelMatrices
+	std::vector<MyRigidBody*> m_lBatchRigidBody; //rigid bodies updated by the last SetModelMatrices
+	std::vector<matrix4> m_lBatchMatrix; //matrices set by the last SetModelMatrices
+
+	std::vector<uint> m_lSlotEntity; //index in the entity list of each handle slot, -1 if the slot is free
+	std::vector<uint> m_lSlotGeneration; //generation of each handle slot, increased every time it is freed
+	std::vector<uint> m_lFreeSlot; //handle slots ready to be reused
+	std::vector<uint> m_lEntitySlot; //handle slot of each entity, same order as the entity list
 public:
 	/*
 	Usage: Gets the singleton pointer
@@ -37,13 +131,47 @@ public:
 	*/
 	int GetEntityIndex(String a_sUniqueID);
 	/*
+	USAGE: Gets the index (from the list of entities) of the entity specified by handle
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: index from the list of entities, -1 if the handle is stale
+	*/
+	int GetEntityIndex(MyEntityHandle a_hEntity);
+	/*
+	USAGE: Asks if the handle still refers to a live entity
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: is the entity still in the list?
+	*/
+	bool IsValid(MyEntityHandle a_hEntity);
+	/*
+	USAGE: Gets the handle of the entity indexed
+	ARGUMENTS: uint a_uIndex -> index of the queried entry
+	OUTPUT: handle of the entity, an invalid handle if out of bounds
+	*/
+	MyEntityHandle GetHandle(uint a_uIndex);
+	/*
 	USAGE: Will add an entity to the list
 	ARGUMENTS:
 	-	String a_sFileName -> Name of the model to load
 	-	String a_sUniqueID -> Name wanted as identifier, if not available will generate one
+	OUTPUT: handle of the new entity, an invalid handle if it could not be created
+	*/
+	MyEntityHandle AddEntity(String a_sFileName, String a_sUniqueID = "NA");
+	/*
+	USAGE: Will add an entity per record to the list, growing the list only once
+	ARGUMENTS:
+	-	std::vector<MyEntityRecord> const& a_lRecord -> entities to create
+	-	std::vector<MyEntityHandle>* a_pHandleList = nullptr -> if given the handle of each
+		record is appended to it, an invalid handle for the ones that could not be created
 	OUTPUT: ---
 	*/
-	void AddEntity(String a_sFileName, String a_sUniqueID = "NA");
+	void AddEntities(std::vector<MyEntityRecord> const& a_lRecord, std::vector<MyEntityHandle>* a_pHandleList = nullptr);
+	/*
+	USAGE: Makes sure the list can hold the specified number of entities without growing
+	ARGUMENTS:
+	-	uint a_uCapacity -> number of entities
+	OUTPUT: ---
+	*/
+	void Reserve(uint a_uCapacity);
 	/*
 	USAGE: Deletes the MyEntity Specified by unique ID and removes it from the list
 	ARGUMENTS: uint a_uIndex -> index of the queried entry, if < 0 asks for the last one added
@@ -57,6 +185,12 @@ public:
 	*/
 	void RemoveEntity(String a_sUniqueID);
 	/*
+	USAGE: Deletes the MyEntity Specified by handle and removes it from the list
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: ---
+	*/
+	void RemoveEntity(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Gets the uniqueID name of the entity indexed
 	ARGUMENTS: uint a_uIndex = -1 -> index of the queried entry, if < 0 asks for the last one added
 	OUTPUT: UniqueID of the entity, if the list is empty will return blank
@@ -69,12 +203,136 @@ public:
 	*/
 	MyEntity* GetEntity(uint a_uIndex = -1);
 	/*
+	USAGE: Gets the uniqueID name of the entity specified by handle
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: UniqueID of the entity, blank if the handle is stale
+	*/
+	String GetUniqueID(MyEntityHandle a_hEntity);
+	/*
+	USAGE: Gets the entity specified by handle
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: entity, nullptr if the handle is stale
+	*/
+	MyEntity* GetEntity(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Will update the MyEntity manager
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
 	void Update(void);
 	/*
+	USAGE: Gets the pairs of entities colliding after the last Update, sorted by handle
+	ARGUMENTS: ---
+	OUTPUT: contact list
+	*/
+	std::vector<MyContactPair> const& GetContactList(void);
+	/*
+	USAGE: Gets the pairs of entities that started colliding in the last Update
+	ARGUMENTS: ---
+	OUTPUT: contact list
+	*/
+	std::vector<MyContactPair> const& GetContactBegin(void);
+	/*
+	USAGE: Gets the pairs of entities that were already colliding and still are after the
+	last Update
+	ARGUMENTS: ---
+	OUTPUT: contact list
+	*/
+	std::vector<MyContactPair> const& GetContactPersist(void);
+	/*
+	USAGE: Gets the pairs of entities that stopped colliding in the last Update, the handle
+	of an entity removed since the update before is already stale
+	ARGUMENTS: ---
+	OUTPUT: contact list
+	*/
+	std::vector<MyContactPair> const& GetContactEnd(void);
+	/*
+	USAGE: Gets the packed global boxes of the entities, indexed like the entity list
+	ARGUMENTS: ---
+	OUTPUT: box store
+	*/
+	MyAABBStore* GetAABBStore(void);
+	/*
+	USAGE: Gets the bounding volume hierarchy of the BP_DYNAMIC_TREE broad phase, it only
+	follows the entities while that broad phase is in use
+	ARGUMENTS: ---
+	OUTPUT: dynamic tree
+	*/
+	MyDynamicTree* GetDynamicTree(void);
+	/*
+	USAGE: Gets the hashed grid of the BP_SPATIAL_HASH broad phase, rebuilt on every update
+	that broad phase runs
+	ARGUMENTS: ---
+	OUTPUT: spatial hash
+	*/
+	MySpatialHash* GetSpatialHash(void);
+	/*
+	USAGE: Sets the octree the BP_OCTREE broad phase will read the leaves from
+	ARGUMENTS: MyOctant* a_pRoot -> root of the octree, nullptr to detach the current one
+	OUTPUT: ---
+	*/
+	void SetOctree(MyOctant* a_pRoot);
+	/*
+	USAGE: Gets the octree the BP_OCTREE broad phase reads the leaves from
+	ARGUMENTS: ---
+	OUTPUT: octree, nullptr if none was set
+	*/
+	MyOctant* GetOctree(void);
+	/*
+	USAGE: Relocates the entities that moved, were added or removed since the last Update in
+	the octree, so it can be queried before the next Update. Does nothing unless the octree is
+	the broad phase in use
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void RefreshOctree(void);
+	/*
+	USAGE: Sets the linear octree the BP_LINEAR_OCTREE broad phase will read the leaves from,
+	the tree is expected to be rebuilt by its owner before every Update
+	ARGUMENTS: MyLinearOctree* a_pTree -> linear octree, nullptr to detach the current one
+	OUTPUT: ---
+	*/
+	void SetLinearOctree(MyLinearOctree* a_pTree);
+	/*
+	USAGE: Sets the loose octree the BP_LOOSE_OCTREE broad phase will ask for pairs, the
+	entities that move are relocated in it on the next Update
+	ARGUMENTS: MyLooseOctree* a_pTree -> loose octree, nullptr to detach the current one
+	OUTPUT: ---
+	*/
+	void SetLooseOctree(MyLooseOctree* a_pTree);
+	/*
+	USAGE: Sets whether the leafs of the octree broad phases are checked by a pool of threads,
+	the colliding pairs are added to the rigid bodies after all threads are done
+	ARGUMENTS: bool a_bParallel -> check in parallel?
+	OUTPUT: ---
+	*/
+	void SetParallel(bool a_bParallel);
+	/*
+	USAGE: Tells whether the leafs of the octree broad phases are checked by a pool of threads
+	ARGUMENTS: ---
+	OUTPUT: are they checked in parallel?
+	*/
+	bool GetParallel(void);
+	/*
+	USAGE: Sets the broad phase used to find the pairs to test in Update, switching to the
+	octree rebuilds it as it stops following the entities while another one is in use
+	ARGUMENTS: eBroadPhase a_eBroadPhase -> broad phase to use
+	OUTPUT: ---
+	*/
+	void SetBroadPhase(eBroadPhase a_eBroadPhase);
+	/*
+	USAGE: Gets the broad phase used to find the pairs to test in Update
+	ARGUMENTS: ---
+	OUTPUT: broad phase in use
+	*/
+	eBroadPhase GetBroadPhase(void);
+	/*
+	USAGE: Gets the name of the broad phase in use
+	ARGUMENTS: ---
+	OUTPUT: name of the broad phase
+	*/
+	String GetBroadPhaseName(void);
+	/*
 	USAGE: Gets the model associated with this entity
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: Model
@@ -87,6 +345,12 @@ public:
 	*/
 	Model* GetModel(String a_sUniqueID);
 	/*
+	USAGE: Gets the model associated with this entity
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: Model
+	*/
+	Model* GetModel(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Gets the Rigid Body associated with this entity
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: Rigid Body
@@ -99,6 +363,12 @@ public:
 	*/
 	MyRigidBody* GetRigidBody(String a_sUniqueID);
 	/*
+	USAGE: Gets the Rigid Body associated with this entity
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: Rigid Body
+	*/
+	MyRigidBody* GetRigidBody(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Gets the model matrix associated with this entity
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: model to world matrix
@@ -111,6 +381,12 @@ public:
 	*/
 	matrix4 GetModelMatrix(String a_sUniqueID);
 	/*
+	USAGE: Gets the model matrix associated with this entity
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: model to world matrix
+	*/
+	matrix4 GetModelMatrix(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Sets the model matrix associated to the entity specified in the ID
 	ARGUMENTS:
 	-	matrix4 a_m4ToWorld -> model matrix to set
@@ -127,6 +403,42 @@ public:
 	*/
 	void SetModelMatrix(matrix4 a_m4ToWorld, String a_sUniqueID);
 	/*
+	USAGE: Sets the model matrix associated to the entity specified by handle
+	ARGUMENTS:
+	-	matrix4 a_m4ToWorld -> model matrix to set
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: ---
+	*/
+	void SetModelMatrix(matrix4 a_m4ToWorld, MyEntityHandle a_hEntity);
+	/*
+	USAGE: Sets the model matrix of several entities at once, their global boxes are
+	computed in a single vectorized pass
+	ARGUMENTS:
+	-	uint const* a_pIndex -> index in the list of each entity, out of bounds entries are skipped
+	-	matrix4 const* a_pToWorld -> model matrix of each entity
+	-	uint a_uCount -> number of entities
+	OUTPUT: ---
+	*/
+	void SetModelMatrices(uint const* a_pIndex, matrix4 const* a_pToWorld, uint a_uCount);
+	/*
+	USAGE: Sets whether the rigid body of the entity is tested along its last move, so a fast
+	entity cannot pass through another one between two updates; the broad phases then
+	use the box it swept
+	ARGUMENTS:
+	-	bool a_bContinuous -> test continuously?
+	-	uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will use the last in the list
+	OUTPUT: ---
+	*/
+	void SetContinuous(bool a_bContinuous, uint a_uIndex = -1);
+	/*
+	USAGE: Sets whether the rigid body of the entity specified by handle is tested along its last move
+	ARGUMENTS:
+	-	bool a_bContinuous -> test continuously?
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: ---
+	*/
+	void SetContinuous(bool a_bContinuous, MyEntityHandle a_hEntity);
+	/*
 	USAGE: Sets the axis visibility associated to the entity specified in the ID
 	ARGUMENTS: 
 	-	bool a_bVisibility -> visibility of the axis
@@ -143,6 +455,14 @@ public:
 	*/
 	void SetAxisVisibility(bool a_bVisibility, String a_sUniqueID);
 	/*
+	USAGE: Sets the model matrix associated to the entity specified by handle
+	ARGUMENTS:
+	-	bool a_bVisibility -> visibility of the axis
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: ---
+	*/
+	void SetAxisVisibility(bool a_bVisibility, MyEntityHandle a_hEntity);
+	/*
 	USAGE: Will add the specified entity to the render list
 	ARGUMENTS:
 	-	uint a_uIndex = -1 -> index (from the list) of the entity queried if < 0 will add all
@@ -159,6 +479,14 @@ public:
 	*/
 	void AddEntityToRenderList(String a_sUniqueID, bool a_bRigidBody = false);
 	/*
+	USAGE: Will add the specified entity by handle to the render list
+	ARGUMENTS:
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	-	bool a_bRigidBody = false -> draw rigid body?
+	OUTPUT: ---
+	*/
+	void AddEntityToRenderList(MyEntityHandle a_hEntity, bool a_bRigidBody = false);
+	/*
 	USAGE: Will set a dimension to the MyEntity
 	ARGUMENTS:
 	-	uint a_uIndex -> index (from the list) of the entity queried if < 0 will use the last one
@@ -175,6 +503,14 @@ public:
 	*/
 	void AddDimension(String a_sUniqueID, uint a_uDimension);
 	/*
+	USAGE: Will set a dimension to the MyEntity
+	ARGUMENTS:
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	-	uint a_uDimension -> dimension to set
+	OUTPUT: ---
+	*/
+	void AddDimension(MyEntityHandle a_hEntity, uint a_uDimension);
+	/*
 	USAGE: Will remove the entity from the specified dimension
 	ARGUMENTS:
 	-	uint a_uIndex -> index (from the list) of the entity queried if < 0 will use the last one
@@ -191,6 +527,14 @@ public:
 	*/
 	void RemoveDimension(String a_sUniqueID, uint a_uDimension);
 	/*
+	USAGE: Will remove the entity from the specified dimension
+	ARGUMENTS:
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	-	uint a_uDimension -> dimension to remove
+	OUTPUT: ---
+	*/
+	void RemoveDimension(MyEntityHandle a_hEntity, uint a_uDimension);
+	/*
 	USAGE: will remove all dimensions from all entities
 	ARGUMENTS: ---
 	OUTPUT: ---
@@ -209,6 +553,12 @@ public:
 	*/
 	void ClearDimensionSet(String a_sUniqueID);
 	/*
+	USAGE: will remove all dimensions from entity
+	ARGUMENTS: MyEntityHandle a_hEntity -> handle of the queried entity
+	OUTPUT: ---
+	*/
+	void ClearDimensionSet(MyEntityHandle a_hEntity);
+	/*
 	USAGE: Will ask if the MyEntity is located in a particular dimension
 	ARGUMENTS:
 	-	uint a_uIndex -> index (from the list) of the entity queried if < 0 will use the last one
@@ -225,6 +575,14 @@ public:
 	*/
 	bool IsInDimension(String a_sUniqueID, uint a_uDimension);
 	/*
+	USAGE: Will ask if the MyEntity is located in a particular dimension
+	ARGUMENTS:
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	-	uint a_uDimension -> dimension queried
+	OUTPUT: result
+	*/
+	bool IsInDimension(MyEntityHandle a_hEntity, uint a_uDimension);
+	/*
 	USAGE: Asks if this entity shares a dimension with the incoming one
 	ARGUMENTS:
 	-	uint a_uIndex -> index (from the list) of the entity queried if < 0 will use the last one
@@ -241,6 +599,14 @@ public:
 	*/
 	bool SharesDimension(String a_sUniqueID, MyEntity* const a_pOther);
 	/*
+	USAGE: Asks if this entity shares a dimension with the incoming one
+	ARGUMENTS:
+	-	MyEntityHandle a_hEntity -> handle of the queried entity
+	-	MyEntity* const a_pOther -> queried entity
+	OUTPUT: shares at least one dimension?
+	*/
+	bool SharesDimension(MyEntityHandle a_hEntity, MyEntity* const a_pOther);
+	/*
 	USAGE: Will return the count of Entities in the system
 	ARGUMENTS: ---
 	OUTPUT: MyEntity count
@@ -283,6 +649,138 @@ private:
 	Output: ---
 	*/
 	void Init(void);
+	/*
+	Usage: checks every pair of entities against each other
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateBruteForce(void);
+	/*
+	Usage: checks only the pairs of entities that share a leaf of the octree
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateOctree(void);
+	/*
+	Usage: checks only the pairs of entities that share a leaf of the linear octree
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateLinearOctree(void);
+	/*
+	Usage: checks only the pairs of entities whose boxes overlap in the sweep and prune
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateSweepAndPrune(void);
+	/*
+	Usage: checks every changed entity against the entities of the loose octants its box reaches
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateLooseOctree(void);
+	/*
+	Usage: checks the pairs of the entity with the entities the loose octree gives for its
+	box, each pair is only checked from one of its changed entities
+	Arguments:
+	-	uint a_uEntity -> index of the entity
+	-	std::vector<uint>& a_lCandidate -> scratch list for the entities the tree gives
+	-	std::vector<uint>* a_pPairList = nullptr -> if given the colliding pairs and the ones
+		the SAT separated are appended to it instead of being added to the rigid bodies
+	Output: ---
+	*/
+	void CheckLoosePairs(uint a_uEntity, std::vector<uint>& a_lCandidate, std::vector<uint>* a_pPairList = nullptr);
+	/*
+	Usage: checks only the pairs of entities whose fattened boxes overlap in the dynamic tree
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateDynamicTree(void);
+	/*
+	Usage: inserts every entity in the dynamic tree from scratch
+	Arguments: ---
+	Output: ---
+	*/
+	void RebuildDynamicTree(void);
+	/*
+	Usage: checks only the pairs of entities whose boxes overlap in a cell of the spatial hash
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateSpatialHash(void);
+	/*
+	Usage: checks the leafs queued in m_lLeafTask over the thread pool, then adds the
+	colliding pairs to the rigid bodies from this thread
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateLeafsParallel(void);
+	/*
+	Usage: empties the pair list of every thread of the pool before a parallel check
+	Arguments: ---
+	Output: ---
+	*/
+	void ClearThreadPairs(void);
+	/*
+	Usage: adds the pairs the threads found colliding to the rigid bodies and the contacts,
+	and keeps the axes that separated the others
+	Arguments: ---
+	Output: ---
+	*/
+	void AddThreadPairs(void);
+	/*
+	Usage: tells whether the entities that move have to be relocated in a tree on Update
+	Arguments: ---
+	Output: are the moves tracked?
+	*/
+	bool IsTrackingMoves(void);
+	/*
+	Usage: checks the pairs of entities of a leaf whose first shared dimension is that leaf
+	Arguments:
+	-	uint const* a_pEntity -> index of the entities in the leaf
+	-	uint a_uCount -> number of entities in the leaf
+	-	int a_nLeafID -> ID of the leaf
+	-	std::vector<uint>* a_pPairList = nullptr -> if given the colliding pairs and the ones
+		the SAT separated are appended to it instead of being added to the rigid bodies
+	Output: ---
+	*/
+	void CheckLeafPairs(uint const* a_pEntity, uint a_uCount, int a_nLeafID, std::vector<uint>* a_pPairList = nullptr);
+	/*
+	Usage: gives a handle slot to the entity that was just added at the end of the list
+	Arguments: ---
+	Output: handle of the entity
+	*/
+	MyEntityHandle AddHandle(void);
+	/*
+	Usage: records the pair of entities as colliding in this update, with how deep their
+	oriented boxes penetrate
+	Arguments:
+	-	uint a_uIndexA -> index of one of the entities
+	-	uint a_uIndexB -> index of the other entity
+	Output: ---
+	*/
+	void AddContact(uint a_uIndexA, uint a_uIndexB);
+	/*
+	Usage: merges the pairs found this update with the ones kept from the last one into the
+	new contact set, sorting the differences into the begin, persist and end lists
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateContacts(void);
+	/*
+	Usage: orders contact pairs by the slot, then the generation, of their handles
+	Arguments:
+	-	MyContactPair const& a_Left -> first pair
+	-	MyContactPair const& a_Right -> second pair
+	Output: does the first pair go before the second?
+	*/
+	static bool IsContactLess(MyContactPair const& a_Left, MyContactPair const& a_Right);
+	/*
+	Usage: makes the next update forget the colliding pairs it kept and test every pair again
+	Arguments: ---
+	Output: ---
+	*/
+	void InvalidatePairCache(void);
 };//class
 
 } //namespace Simplex
@@ -0,0 +1,393 @@
+#include "MyLinearOctree.h"
+using namespace Simplex;
+
+void MyLinearOctree::Init()
+{
+	m_uMaxLevel = 0;
+	m_uIdealEntityCount = 5;
+
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+
+	m_v3Min = vector3(0.0f);
+	m_v3Max = vector3(0.0f);
+	m_v3Center = vector3(0.0f);
+	m_fSize = 0.0f;
+}
+
+MyLinearOctree::MyLinearOctree(uint a_nMaxLevel, uint a_nIdealEntityCount)
+{
+	Init();
+	m_uIdealEntityCount = a_nIdealEntityCount;
+	ConstructTree(a_nMaxLevel);
+}
+
+MyLinearOctree::MyLinearOctree(MyLinearOctree const& other)
+{
+	m_uMaxLevel = other.m_uMaxLevel;
+	m_uIdealEntityCount = other.m_uIdealEntityCount;
+
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+
+	m_v3Min = other.m_v3Min;
+	m_v3Max = other.m_v3Max;
+	m_v3Center = other.m_v3Center;
+	m_fSize = other.m_fSize;
+
+	m_lCode = other.m_lCode;
+	m_lSorted = other.m_lSorted;
+	m_lNode = other.m_lNode;
+	m_lLeaf = other.m_lLeaf;
+	m_lLeafOffset = other.m_lLeafOffset;
+	m_lLeafEntity = other.m_lLeafEntity;
+}
+
+MyLinearOctree& MyLinearOctree::operator=(MyLinearOctree const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		MyLinearOctree temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+MyLinearOctree::~MyLinearOctree()
+{
+	Release();
+}
+
+void MyLinearOctree::Release()
+{
+	m_lCode.clear();
+	m_lSorted.clear();
+	m_lNode.clear();
+	m_lLeaf.clear();
+	m_lLeafOffset.clear();
+	m_lLeafEntity.clear();
+}
+
+void MyLinearOctree::Swap(MyLinearOctree& other)
+{
+	std::swap(m_uMaxLevel, other.m_uMaxLevel);
+	std::swap(m_uIdealEntityCount, other.m_uIdealEntityCount);
+	std::swap(m_v3Min, other.m_v3Min);
+	std::swap(m_v3Max, other.m_v3Max);
+	std::swap(m_v3Center, other.m_v3Center);
+	std::swap(m_fSize, other.m_fSize);
+	std::swap(m_lCode, other.m_lCode);
+	std::swap(m_lSorted, other.m_lSorted);
+	std::swap(m_lCodeTemp, other.m_lCodeTemp);
+	std::swap(m_lSortedTemp, other.m_lSortedTemp);
+	std::swap(m_lNode, other.m_lNode);
+	std::swap(m_lLeaf, other.m_lLeaf);
+	std::swap(m_lLeafOffset, other.m_lLeafOffset);
+	std::swap(m_lLeafEntity, other.m_lLeafEntity);
+	std::swap(m_lPairLeaf, other.m_lPairLeaf);
+	std::swap(m_lPairEntity, other.m_lPairEntity);
+	std::swap(m_lNodeOffset, other.m_lNodeOffset);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+uint MyLinearOctree::GetMaxLevel()
+{
+	return m_uMaxLevel;
+}
+
+uint MyLinearOctree::GetOctantCount()
+{
+	return m_lNode.size();
+}
+
+uint MyLinearOctree::GetLeafCount()
+{
+	return m_lLeaf.size();
+}
+
+uint MyLinearOctree::GetLeafID(uint a_uIndex)
+{
+	if (a_uIndex >= m_lLeaf.size())
+	{
+		return -1;
+	}
+	return m_lLeaf[a_uIndex];
+}
+
+uint MyLinearOctree::GetLeafEntityCount(uint a_uIndex)
+{
+	if (a_uIndex >= m_lLeaf.size())
+	{
+		return 0;
+	}
+	return m_lLeafOffset[a_uIndex + 1] - m_lLeafOffset[a_uIndex];
+}
+
+uint const* MyLinearOctree::GetLeafEntityList(uint a_uIndex)
+{
+	if (a_uIndex >= m_lLeaf.size())
+	{
+		return nullptr;
+	}
+	return &m_lLeafEntity[m_lLeafOffset[a_uIndex]];
+}
+
+void MyLinearOctree::ConstructTree(uint a_nMaxLevel)
+{
+	//the codes cannot tell apart octants deeper than their bits per axis
+	m_uMaxLevel = a_nMaxLevel < m_uCodeBits ? a_nMaxLevel : m_uCodeBits;
+
+	m_lNode.clear();
+	m_lLeaf.clear();
+	m_lLeafOffset.clear();
+	m_lLeafEntity.clear();
+
+	//dimensions from a previous tree would point to octants that no longer exist
+	m_pEntityMngr->ClearDimensionSetAll();
+
+	ComputeBounds();
+	SortCodes();
+
+	Node root;
+	root.m_v3Center = m_v3Center;
+	root.m_fSize = m_fSize;
+	root.m_uBegin = 0;
+	root.m_uEnd = m_lCode.size();
+	m_lNode.push_back(root);
+	Subdivide(0);
+
+	AssignIDtoEntity();
+}
+
+void MyLinearOctree::ComputeBounds()
+{
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (nObjects == 0)
+	{
+		m_v3Min = m_v3Max = m_v3Center = vector3(0.0f);
+		m_fSize = 0.0f;
+		return;
+	}
+
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	vector3 v3Min = pStore->GetMin(0);
+	vector3 v3Max = pStore->GetMax(0);
+	for (uint i = 1; i < nObjects; i++)
+	{
+		v3Min = glm::min(v3Min, pStore->GetMin(i));
+		v3Max = glm::max(v3Max, pStore->GetMax(i));
+	}
+
+	//same cube MyOctant fits around the entities
+	vector3 vHalfWidth = (v3Max - v3Min) / 2.0f;
+	float fMax = std::max(vHalfWidth.x, std::max(vHalfWidth.y, vHalfWidth.z));
+
+	m_fSize = fMax * 2.0f;
+	m_v3Center = (v3Max + v3Min) / 2.0f;
+	m_v3Min = m_v3Center - vector3(fMax);
+	m_v3Max = m_v3Center + vector3(fMax);
+}
+
+uint MyLinearOctree::ExpandBits(uint a_uValue)
+{
+	a_uValue = (a_uValue * 0x00010001u) & 0xFF0000FFu;
+	a_uValue = (a_uValue * 0x00000101u) & 0x0F00F00Fu;
+	a_uValue = (a_uValue * 0x00000011u) & 0xC30C30C3u;
+	a_uValue = (a_uValue * 0x00000005u) & 0x49249249u;
+	return a_uValue;
+}
+
+void MyLinearOctree::SortCodes()
+{
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	m_lCode.resize(nObjects);
+	m_lSorted.resize(nObjects);
+	m_lCodeTemp.resize(nObjects);
+	m_lSortedTemp.resize(nObjects);
+
+	const uint uCells = 1 << m_uCodeBits;
+	float fScale = m_fSize > 0.0f ? uCells / m_fSize : 0.0f;
+	for (uint i = 0; i < nObjects; i++)
+	{
+		vector3 v3Cell = (m_pEntityMngr->GetRigidBody(i)->GetCenterGlobal() - m_v3Min) * fScale;
+		uint uCell[3];
+		for (uint j = 0; j < 3; j++)
+		{
+			uCell[j] = static_cast<uint>(glm::clamp(v3Cell[j], 0.0f, static_cast<float>(uCells - 1)));
+		}
+		m_lCode[i] = (ExpandBits(uCell[0]) << 2) | (ExpandBits(uCell[1]) << 1) | ExpandBits(uCell[2]);
+		m_lSorted[i] = i;
+	}
+
+	//least significant digit radix sort, one pass per 10 bits
+	const uint uRadix = 1 << m_uCodeBits;
+	std::vector<uint> lCount(uRadix);
+	for (uint uShift = 0; uShift < 3 * m_uCodeBits; uShift += m_uCodeBits)
+	{
+		std::fill(lCount.begin(), lCount.end(), 0);
+		for (uint i = 0; i < nObjects; i++)
+		{
+			lCount[(m_lCode[i] >> uShift) & (uRadix - 1)]++;
+		}
+		uint uSum = 0;
+		for (uint i = 0; i < uRadix; i++)
+		{
+			uint uTemp = lCount[i];
+			lCount[i] = uSum;
+			uSum += uTemp;
+		}
+		for (uint i = 0; i < nObjects; i++)
+		{
+			uint uDigit = (m_lCode[i] >> uShift) & (uRadix - 1);
+			m_lCodeTemp[lCount[uDigit]] = m_lCode[i];
+			m_lSortedTemp[lCount[uDigit]] = m_lSorted[i];
+			lCount[uDigit]++;
+		}
+		std::swap(m_lCode, m_lCodeTemp);
+		std::swap(m_lSorted, m_lSortedTemp);
+	}
+}
+
+void MyLinearOctree::Subdivide(uint a_uNode)
+{
+	//copy, the node list grows below
+	Node node = m_lNode[a_uNode];
+
+	//the root always subdivides, the rest only when over the ideal count
+	if (node.m_uLevel >= m_uMaxLevel || (node.m_uLevel > 0 && node.m_uEnd - node.m_uBegin <= m_uIdealEntityCount))
+	{
+		return;
+	}
+
+	uint uFirst = m_lNode.size();
+	m_lNode[a_uNode].m_uFirstChild = uFirst;
+	m_lNode[a_uNode].m_uChildren = 8;
+
+	//the 3 bits of the code under the parent's prefix pick the child, as the codes are
+	//sorted the entities of each child follow each other. Every child is created, even
+	//empty ones, so the leafs cover the whole root for the overlap pass
+	uint uShift = 3 * (m_uCodeBits - node.m_uLevel - 1);
+	float fChildSize = node.m_fSize / 2.0f;
+	float fOffset = node.m_fSize / 4.0f;
+	uint uCursor = node.m_uBegin;
+	for (uint k = 0; k < 8; k++)
+	{
+		Node child;
+		child.m_v3Center = node.m_v3Center + vector3(
+			(k & 4) ? fOffset : -fOffset,
+			(k & 2) ? fOffset : -fOffset,
+			(k & 1) ? fOffset : -fOffset);
+		child.m_fSize = fChildSize;
+		child.m_uLevel = node.m_uLevel + 1;
+		child.m_uBegin = uCursor;
+		while (uCursor < node.m_uEnd && ((m_lCode[uCursor] >> uShift) & 7) == k)
+		{
+			uCursor++;
+		}
+		child.m_uEnd = uCursor;
+		m_lNode.push_back(child);
+	}
+
+	for (uint k = 0; k < 8; k++)
+	{
+		Subdivide(uFirst + k);
+	}
+}
+
+void MyLinearOctree::CollectLeafs(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lLeaf)
+{
+	Node const& node = m_lNode[a_uNode];
+	float fHalf = node.m_fSize / 2.0f;
+	if (node.m_v3Center.x + fHalf < a_v3Min.x || node.m_v3Center.x - fHalf > a_v3Max.x ||
+		node.m_v3Center.y + fHalf < a_v3Min.y || node.m_v3Center.y - fHalf > a_v3Max.y ||
+		node.m_v3Center.z + fHalf < a_v3Min.z || node.m_v3Center.z - fHalf > a_v3Max.z)
+	{
+		return;
+	}
+	if (node.m_uChildren == 0)
+	{
+		a_lLeaf.push_back(a_uNode);
+		return;
+	}
+	for (uint k = 0; k < node.m_uChildren; k++)
+	{
+		CollectLeafs(node.m_uFirstChild + k, a_v3Min, a_v3Max, a_lLeaf);
+	}
+}
+
+void MyLinearOctree::AssignIDtoEntity()
+{
+	//an entity is placed by its center, but it belongs to every leaf its box overlaps
+	m_lPairLeaf.clear();
+	m_lPairEntity.clear();
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	for (uint i = 0; i < nObjects; i++)
+	{
+		uint uFirst = m_lPairLeaf.size();
+		CollectLeafs(0, pStore->GetMin(i), pStore->GetMax(i), m_lPairLeaf);
+		m_lPairEntity.resize(m_lPairLeaf.size(), i);
+		for (uint j = uFirst; j < m_lPairLeaf.size(); j++)
+		{
+			m_pEntityMngr->AddDimension(i, m_lPairLeaf[j]);
+		}
+	}
+
+	//bucket the overlaps by leaf with a counting sort
+	uint uNodeCount = m_lNode.size();
+	m_lNodeOffset.assign(uNodeCount + 1, 0);
+	for (uint i = 0; i < m_lPairLeaf.size(); i++)
+	{
+		m_lNodeOffset[m_lPairLeaf[i] + 1]++;
+	}
+	for (uint i = 0; i < uNodeCount; i++)
+	{
+		if (m_lNodeOffset[i + 1] > 0)
+		{
+			m_lLeaf.push_back(i);
+		}
+		m_lNodeOffset[i + 1] += m_lNodeOffset[i];
+	}
+
+	m_lLeafEntity.resize(m_lPairLeaf.size());
+	for (uint i = 0; i < m_lLeaf.size(); i++)
+	{
+		m_lLeafOffset.push_back(m_lNodeOffset[m_lLeaf[i]]);
+	}
+	m_lLeafOffset.push_back(m_lPairLeaf.size());
+
+	//entities were visited in order, so each leaf list ends up sorted
+	for (uint i = 0; i < m_lPairLeaf.size(); i++)
+	{
+		m_lLeafEntity[m_lNodeOffset[m_lPairLeaf[i]]++] = m_lPairEntity[i];
+	}
+}
+
+void MyLinearOctree::Display(uint a_nIndex, vector3 a_v3Color)
+{
+	if (a_nIndex >= m_lNode.size())
+	{
+		return;
+	}
+	Node const& node = m_lNode[a_nIndex];
+	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, node.m_v3Center) * glm::scale(vector3(node.m_fSize)), a_v3Color, RENDER_WIRE);
+}
+
+void MyLinearOctree::Display(vector3 a_v3Color)
+{
+	for (uint i = 0; i < m_lNode.size(); i++)
+	{
+		Display(i, a_v3Color);
+	}
+}
+
+void MyLinearOctree::DisplayLeafs(vector3 a_v3Color)
+{
+	for (uint i = 0; i < m_lLeaf.size(); i++)
+	{
+		Display(m_lLeaf[i], a_v3Color);
+	}
+}
@@ -0,0 +1,211 @@
+#ifndef MYLINEAROCTREECLASS_H
+#define MYLINEAROCTREECLASS_H
+
+#include "MyEntityManager.h"
+
+using namespace Simplex;
+
+class MyLinearOctree
+{
+	// An octant of the tree, children of a node are stored next to each other
+	struct Node
+	{
+		vector3 m_v3Center = vector3(0.0f); // Center of the octant in global space
+		float m_fSize = 0.0f; // Size of each side of the octant
+		uint m_uLevel = 0; // Level of the octant
+		uint m_uFirstChild = 0; // Index of the first child in the node list
+		uint m_uChildren = 0; // Number of children (either 0 or 8)
+		uint m_uBegin = 0; // First entity (in sorted order) whose center falls in this octant
+		uint m_uEnd = 0; // One past the last entity whose center falls in this octant
+	};
+
+	static const uint m_uCodeBits = 10; // Bits per axis of the Morton codes (30 bit codes)
+
+	uint m_uMaxLevel = 0; // Max level of subdivision
+	uint m_uIdealEntityCount = 5; // How many ideal entities an octant will contain
+
+	MeshManager* m_pMeshMngr = nullptr;
+	MyEntityManager* m_pEntityMngr = nullptr;
+
+	vector3 m_v3Min = vector3(0.0f); // Minimum of the root in global space
+	vector3 m_v3Max = vector3(0.0f); // Maximum of the root in global space
+	vector3 m_v3Center = vector3(0.0f); // Center of the root in global space
+	float m_fSize = 0.0f; // Size of the root
+
+	std::vector<uint> m_lCode; // Morton code of each entity center, sorted
+	std::vector<uint> m_lSorted; // Entity index (in the Entity Manager) matching each sorted code
+	std::vector<uint> m_lCodeTemp; // Scratch buffer for the radix sort
+	std::vector<uint> m_lSortedTemp; // Scratch buffer for the radix sort
+
+	std::vector<Node> m_lNode; // Every octant of the tree, the root is the first one
+
+	std::vector<uint> m_lLeaf; // Index of the leafs that contain entities
+	std::vector<uint> m_lLeafOffset; // Where the entity list of each non empty leaf starts in m_lLeafEntity
+	std::vector<uint> m_lLeafEntity; // Entity lists of the non empty leafs, one after the other
+
+	std::vector<uint> m_lPairLeaf; // Leaf of each (leaf, entity) overlap found while assigning
+	std::vector<uint> m_lPairEntity; // Entity of each (leaf, entity) overlap found while assigning
+	std::vector<uint> m_lNodeOffset; // Where the entities of each node start while bucketing the overlaps
+
+public:
+	/*
+	USAGE: Constructor, will create a linear octree with the entities the Entity Manager
+	currently contains
+	ARGUMENTS:
+	- uint a_nMaxLevel = 2 -> Sets the maximum level of subdivision
+	- uint a_nIdealEntityCount = 5 -> Sets the ideal level of objects per octant
+	OUTPUT: class object
+	*/
+	MyLinearOctree(uint a_nMaxLevel = 2, uint a_nIdealEntityCount = 5);
+	/*
+	USAGE: Copy Constructor
+	ARGUMENTS: class object to copy
+	OUTPUT: class object instance
+	*/
+	MyLinearOctree(MyLinearOctree const& other);
+	/*
+	USAGE: Copy Assignment Operator
+	ARGUMENTS: class object to copy
+	OUTPUT: ---
+	*/
+	MyLinearOctree& operator=(MyLinearOctree const& other);
+	/*
+	USAGE: Destructor
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	~MyLinearOctree(void);
+	/*
+	USAGE: Changes object contents for other object's
+	ARGUMENTS:
+	- MyLinearOctree& other -> object to swap content from
+	OUTPUT: ---
+	*/
+	void Swap(MyLinearOctree& other);
+	/*
+	USAGE: Rebuilds the tree from the current position of the entities: fits the root around
+	them, sorts their Morton codes and derives the octants from the sorted order
+	ARGUMENTS:
+	- uint a_nMaxLevel = 3 -> Sets the maximum level of the tree (at most 10)
+	OUTPUT: ---
+	*/
+	void ConstructTree(uint a_nMaxLevel = 3);
+	/*
+	USAGE: Gets the max level of subdivision of the tree
+	ARGUMENTS: ---
+	OUTPUT: max level
+	*/
+	uint GetMaxLevel(void);
+	/*
+	USAGE: Gets the total number of octants in the tree
+	ARGUMENTS: ---
+	OUTPUT: octant count
+	*/
+	uint GetOctantCount(void);
+	/*
+	USAGE: Gets the number of leafs that contain entities
+	ARGUMENTS: ---
+	OUTPUT: number of non empty leafs
+	*/
+	uint GetLeafCount(void);
+	/*
+	USAGE: Gets the ID of the non empty leaf specified by index, this is the dimension its
+	entities are tagged with
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: ID of the leaf, -1 if out of bounds
+	*/
+	uint GetLeafID(uint a_uIndex);
+	/*
+	USAGE: Gets the number of entities in the non empty leaf specified by index
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: entity count
+	*/
+	uint GetLeafEntityCount(uint a_uIndex);
+	/*
+	USAGE: Gets the entities (index in the Entity Manager) overlapping the non empty leaf
+	specified by index
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: pointer to the first of GetLeafEntityCount entries, nullptr if out of bounds
+	*/
+	uint const* GetLeafEntityList(uint a_uIndex);
+	/*
+	USAGE: Displays the octant specified by ID
+	ARGUMENTS:
+	- uint a_nIndex -> Octant to be displayed.
+	- vector3 a_v3Color = C_YELLOW -> Color of the volume to display.
+	OUTPUT: ---
+	*/
+	void Display(uint a_nIndex, vector3 a_v3Color = C_YELLOW);
+	/*
+	USAGE: Displays every octant of the tree
+	ARGUMENTS:
+	- vector3 a_v3Color = C_YELLOW -> Color of the volume to display.
+	OUTPUT: ---
+	*/
+	void Display(vector3 a_v3Color = C_YELLOW);
+	/*
+	USAGE: Displays the non empty leafs in the tree
+	ARGUMENTS:
+	- vector3 a_v3Color = C_YELLOW -> Color of the volume to display.
+	OUTPUT: ---
+	*/
+	void DisplayLeafs(vector3 a_v3Color = C_YELLOW);
+
+private:
+	/*
+	USAGE: Deallocates member fields
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Release(void);
+	/*
+	USAGE: Allocates member fields
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Init(void);
+	/*
+	USAGE: Fits the root cube around the global bounding box of every entity
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void ComputeBounds(void);
+	/*
+	USAGE: Computes the Morton code of every entity center and radix sorts them
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void SortCodes(void);
+	/*
+	USAGE: Creates the children of the node specified by index out of its range of
+	sorted codes, recursing into the ones that are still over the ideal count
+	ARGUMENTS: uint a_uNode -> index of the node to subdivide
+	OUTPUT: ---
+	*/
+	void Subdivide(uint a_uNode);
+	/*
+	USAGE: Fills the entity list of each leaf with every entity whose bounding box
+	overlaps it and tags the entities with the ID of those leafs
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void AssignIDtoEntity(void);
+	/*
+	USAGE: Collects the leafs under the node specified by index the box overlaps
+	ARGUMENTS:
+	- uint a_uNode -> index of the node to start from
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- std::vector<uint>& a_lLeaf -> list to append the leafs to
+	OUTPUT: ---
+	*/
+	void CollectLeafs(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lLeaf);
+	/*
+	USAGE: Spreads the lower 10 bits of the input so there are two zeros between each bit
+	ARGUMENTS: uint a_uValue -> value to spread
+	OUTPUT: spread value
+	*/
+	static uint ExpandBits(uint a_uValue);
+};
+
+#endif
@@ -0,0 +1,449 @@
+#include "MyLooseOctree.h"
+using namespace Simplex;
+
+void MyLooseOctree::Init()
+{
+	m_uMaxLevel = 0;
+	m_fLooseness = 2.0f;
+
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+
+	m_v3Min = vector3(0.0f);
+	m_v3Max = vector3(0.0f);
+	m_v3Center = vector3(0.0f);
+	m_fSize = 0.0f;
+
+	m_uEntityCount = 0;
+	m_uRelocated = 0;
+}
+
+MyLooseOctree::MyLooseOctree(uint a_nMaxLevel, float a_fLooseness)
+{
+	Init();
+	m_fLooseness = std::max(a_fLooseness, 1.0f);
+	ConstructTree(a_nMaxLevel);
+}
+
+MyLooseOctree::MyLooseOctree(MyLooseOctree const& other)
+{
+	m_uMaxLevel = other.m_uMaxLevel;
+	m_fLooseness = other.m_fLooseness;
+
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+
+	m_v3Min = other.m_v3Min;
+	m_v3Max = other.m_v3Max;
+	m_v3Center = other.m_v3Center;
+	m_fSize = other.m_fSize;
+
+	m_lLevelOffset = other.m_lLevelOffset;
+	m_lHead = other.m_lHead;
+	m_lSubtreeCount = other.m_lSubtreeCount;
+	m_lEntityOctant = other.m_lEntityOctant;
+	m_lNext = other.m_lNext;
+	m_lPrev = other.m_lPrev;
+	m_uEntityCount = other.m_uEntityCount;
+	m_uRelocated = other.m_uRelocated;
+}
+
+MyLooseOctree& MyLooseOctree::operator=(MyLooseOctree const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		MyLooseOctree temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+
+MyLooseOctree::~MyLooseOctree()
+{
+	Release();
+}
+
+void MyLooseOctree::Release()
+{
+	m_lLevelOffset.clear();
+	m_lHead.clear();
+	m_lSubtreeCount.clear();
+	m_lEntityOctant.clear();
+	m_lNext.clear();
+	m_lPrev.clear();
+	m_uEntityCount = 0;
+}
+
+void MyLooseOctree::Swap(MyLooseOctree& other)
+{
+	std::swap(m_uMaxLevel, other.m_uMaxLevel);
+	std::swap(m_fLooseness, other.m_fLooseness);
+	std::swap(m_v3Min, other.m_v3Min);
+	std::swap(m_v3Max, other.m_v3Max);
+	std::swap(m_v3Center, other.m_v3Center);
+	std::swap(m_fSize, other.m_fSize);
+	std::swap(m_lLevelOffset, other.m_lLevelOffset);
+	std::swap(m_lHead, other.m_lHead);
+	std::swap(m_lSubtreeCount, other.m_lSubtreeCount);
+	std::swap(m_lEntityOctant, other.m_lEntityOctant);
+	std::swap(m_lNext, other.m_lNext);
+	std::swap(m_lPrev, other.m_lPrev);
+	std::swap(m_uEntityCount, other.m_uEntityCount);
+	std::swap(m_uRelocated, other.m_uRelocated);
+	m_pMeshMngr = MeshManager::GetInstance();
+	m_pEntityMngr = MyEntityManager::GetInstance();
+}
+
+uint MyLooseOctree::GetMaxLevel()
+{
+	return m_uMaxLevel;
+}
+
+float MyLooseOctree::GetLooseness()
+{
+	return m_fLooseness;
+}
+
+uint MyLooseOctree::GetOctantCount()
+{
+	return m_lHead.size();
+}
+
+uint MyLooseOctree::GetEntityOctant(uint a_uIndex)
+{
+	if (a_uIndex >= m_uEntityCount)
+	{
+		return -1;
+	}
+	return m_lEntityOctant[a_uIndex];
+}
+
+uint MyLooseOctree::GetRelocatedCount()
+{
+	return m_uRelocated;
+}
+
+void MyLooseOctree::ConstructTree(uint a_nMaxLevel)
+{
+	//every octant of every level exists, so the arrays grow by 8 per level
+	m_uMaxLevel = a_nMaxLevel < m_uLevelCap ? a_nMaxLevel : m_uLevelCap;
+
+	m_lLevelOffset.resize(m_uMaxLevel + 1);
+	uint uOctantCount = 0;
+	for (uint i = 0; i <= m_uMaxLevel; i++)
+	{
+		m_lLevelOffset[i] = uOctantCount;
+		uOctantCount += 1 << (3 * i);
+	}
+	m_lHead.assign(uOctantCount, static_cast<uint>(-1));
+	m_lSubtreeCount.assign(uOctantCount, 0);
+
+	ComputeBounds();
+
+	//the pairs are found by asking the tree, the entities are not filtered by dimension
+	m_pEntityMngr->ClearDimensionSetAll();
+
+	m_uEntityCount = m_pEntityMngr->GetEntityCount();
+	m_lEntityOctant.resize(m_uEntityCount);
+	m_lNext.resize(m_uEntityCount);
+	m_lPrev.resize(m_uEntityCount);
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	for (uint i = 0; i < m_uEntityCount; i++)
+	{
+		Link(i, FindOctant(pStore->GetMin(i), pStore->GetMax(i)));
+	}
+	m_uRelocated = m_uEntityCount;
+}
+
+void MyLooseOctree::UpdateEntities(std::vector<uint> const& a_lEntity)
+{
+	//removals are followed as they happen, a tree holding more entities than the manager
+	//was not told about them
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (nObjects < m_uEntityCount)
+	{
+		ConstructTree(m_uMaxLevel);
+		return;
+	}
+
+	m_uRelocated = 0;
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+
+	//the entities added since the last update are stored for the first time
+	m_lEntityOctant.resize(nObjects, static_cast<uint>(-1));
+	m_lNext.resize(nObjects, static_cast<uint>(-1));
+	m_lPrev.resize(nObjects, static_cast<uint>(-1));
+	for (uint i = m_uEntityCount; i < nObjects; i++)
+	{
+		Link(i, FindOctant(pStore->GetMin(i), pStore->GetMax(i)));
+		++m_uRelocated;
+	}
+	m_uEntityCount = nObjects;
+
+	for (uint i = 0; i < a_lEntity.size(); i++)
+	{
+		uint uEntity = a_lEntity[i];
+		if (uEntity >= m_uEntityCount)
+		{
+			continue;
+		}
+		uint uOctant = FindOctant(pStore->GetMin(uEntity), pStore->GetMax(uEntity));
+		if (uOctant == m_lEntityOctant[uEntity])
+		{
+			continue;
+		}
+		//an added entity that took the index of a removed one is not stored yet
+		if (m_lEntityOctant[uEntity] != static_cast<uint>(-1))
+		{
+			Unlink(uEntity);
+		}
+		Link(uEntity, uOctant);
+		++m_uRelocated;
+	}
+}
+
+void MyLooseOctree::RemoveEntity(uint a_uIndex)
+{
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (a_uIndex >= nObjects)
+	{
+		return;
+	}
+
+	//take the entity out of its octant
+	if (a_uIndex < m_uEntityCount && m_lEntityOctant[a_uIndex] != static_cast<uint>(-1))
+	{
+		Unlink(a_uIndex);
+	}
+
+	//the last entity takes its index and is stored again under it, if it was not stored
+	//yet the index waits for its move in the next update
+	uint uLast = nObjects - 1;
+	if (a_uIndex != uLast && a_uIndex < m_uEntityCount)
+	{
+		uint uOctant = uLast < m_uEntityCount ? m_lEntityOctant[uLast] : static_cast<uint>(-1);
+		if (uOctant != static_cast<uint>(-1))
+		{
+			Unlink(uLast);
+			Link(a_uIndex, uOctant);
+		}
+		else
+		{
+			m_lEntityOctant[a_uIndex] = static_cast<uint>(-1);
+		}
+	}
+
+	if (uLast < m_uEntityCount)
+	{
+		m_uEntityCount = uLast;
+		m_lEntityOctant.resize(m_uEntityCount);
+		m_lNext.resize(m_uEntityCount);
+		m_lPrev.resize(m_uEntityCount);
+	}
+}
+
+void MyLooseOctree::ComputeBounds()
+{
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (nObjects == 0)
+	{
+		m_v3Min = m_v3Max = m_v3Center = vector3(0.0f);
+		m_fSize = 0.0f;
+		return;
+	}
+
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	vector3 v3Min = pStore->GetMin(0);
+	vector3 v3Max = pStore->GetMax(0);
+	for (uint i = 1; i < nObjects; i++)
+	{
+		v3Min = glm::min(v3Min, pStore->GetMin(i));
+		v3Max = glm::max(v3Max, pStore->GetMax(i));
+	}
+
+	//same cube MyOctant fits around the entities
+	vector3 vHalfWidth = (v3Max - v3Min) / 2.0f;
+	float fMax = std::max(vHalfWidth.x, std::max(vHalfWidth.y, vHalfWidth.z));
+
+	m_fSize = fMax * 2.0f;
+	m_v3Center = (v3Max + v3Min) / 2.0f;
+	m_v3Min = m_v3Center - vector3(fMax);
+	m_v3Max = m_v3Center + vector3(fMax);
+}
+
+uint MyLooseOctree::GetOctantIndex(uint a_uLevel, uint a_uX, uint a_uY, uint a_uZ)
+{
+	return m_lLevelOffset[a_uLevel] + a_uX + (a_uY << a_uLevel) + (a_uZ << (2 * a_uLevel));
+}
+
+void MyLooseOctree::DecodeOctant(uint a_uOctant, uint& a_uLevel, uint& a_uX, uint& a_uY, uint& a_uZ)
+{
+	a_uLevel = 0;
+	while (a_uLevel < m_uMaxLevel && a_uOctant >= m_lLevelOffset[a_uLevel + 1])
+	{
+		a_uLevel++;
+	}
+	uint uCell = a_uOctant - m_lLevelOffset[a_uLevel];
+	uint uMask = (1 << a_uLevel) - 1;
+	a_uX = uCell & uMask;
+	a_uY = (uCell >> a_uLevel) & uMask;
+	a_uZ = uCell >> (2 * a_uLevel);
+}
+
+uint MyLooseOctree::FindOctant(vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	if (m_fSize <= 0.0f)
+	{
+		return 0;
+	}
+
+	//the cell comes from the center and the level from the size, going up while the box
+	//does not fit. A center out of the root is clamped to its border, boxes that still do
+	//not fit stay in the root, whose loose cube has no bounds
+	vector3 v3Center = (a_v3Min + a_v3Max) / 2.0f;
+	vector3 v3Half = (a_v3Max - a_v3Min) / 2.0f;
+	float fHalf = std::max(v3Half.x, std::max(v3Half.y, v3Half.z));
+	for (uint uLevel = m_uMaxLevel; uLevel > 0; uLevel--)
+	{
+		float fCell = m_fSize / static_cast<float>(1 << uLevel);
+		float fMargin = (m_fLooseness - 1.0f) * fCell / 2.0f;
+		if (fHalf > fMargin)
+		{
+			continue;
+		}
+		uint uCell[3];
+		vector3 v3LooseMin;
+		vector3 v3LooseMax;
+		for (uint i = 0; i < 3; i++)
+		{
+			float fCellIndex = std::floor((v3Center[i] - m_v3Min[i]) / fCell);
+			uCell[i] = static_cast<uint>(glm::clamp(fCellIndex, 0.0f, static_cast<float>((1 << uLevel) - 1)));
+			v3LooseMin[i] = m_v3Min[i] + uCell[i] * fCell - fMargin;
+			v3LooseMax[i] = v3LooseMin[i] + fCell + 2.0f * fMargin;
+		}
+		if (a_v3Min.x < v3LooseMin.x || a_v3Min.y < v3LooseMin.y || a_v3Min.z < v3LooseMin.z ||
+			a_v3Max.x > v3LooseMax.x || a_v3Max.y > v3LooseMax.y || a_v3Max.z > v3LooseMax.z)
+		{
+			continue;
+		}
+		return GetOctantIndex(uLevel, uCell[0], uCell[1], uCell[2]);
+	}
+	return 0;
+}
+
+void MyLooseOctree::Link(uint a_uEntity, uint a_uOctant)
+{
+	m_lEntityOctant[a_uEntity] = a_uOctant;
+	m_lPrev[a_uEntity] = static_cast<uint>(-1);
+	m_lNext[a_uEntity] = m_lHead[a_uOctant];
+	if (m_lHead[a_uOctant] != static_cast<uint>(-1))
+	{
+		m_lPrev[m_lHead[a_uOctant]] = a_uEntity;
+	}
+	m_lHead[a_uOctant] = a_uEntity;
+
+	//the queries skip the branches that store nothing
+	uint uLevel, uX, uY, uZ;
+	DecodeOctant(a_uOctant, uLevel, uX, uY, uZ);
+	for (uint i = 0; i <= uLevel; i++)
+	{
+		m_lSubtreeCount[GetOctantIndex(uLevel - i, uX >> i, uY >> i, uZ >> i)]++;
+	}
+}
+
+void MyLooseOctree::Unlink(uint a_uEntity)
+{
+	uint uOctant = m_lEntityOctant[a_uEntity];
+	if (m_lPrev[a_uEntity] != static_cast<uint>(-1))
+	{
+		m_lNext[m_lPrev[a_uEntity]] = m_lNext[a_uEntity];
+	}
+	else
+	{
+		m_lHead[uOctant] = m_lNext[a_uEntity];
+	}
+	if (m_lNext[a_uEntity] != static_cast<uint>(-1))
+	{
+		m_lPrev[m_lNext[a_uEntity]] = m_lPrev[a_uEntity];
+	}
+
+	uint uLevel, uX, uY, uZ;
+	DecodeOctant(uOctant, uLevel, uX, uY, uZ);
+	for (uint i = 0; i <= uLevel; i++)
+	{
+		m_lSubtreeCount[GetOctantIndex(uLevel - i, uX >> i, uY >> i, uZ >> i)]--;
+	}
+}
+
+void MyLooseOctree::GetCandidates(vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lEntity)
+{
+	if (m_lHead.size() == 0)
+	{
+		return;
+	}
+	CollectCandidates(0, 0, 0, 0, a_v3Min, a_v3Max, a_lEntity);
+}
+
+void MyLooseOctree::CollectCandidates(uint a_uLevel, uint a_uX, uint a_uY, uint a_uZ, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lEntity)
+{
+	uint uOctant = GetOctantIndex(a_uLevel, a_uX, a_uY, a_uZ);
+	if (m_lSubtreeCount[uOctant] == 0)
+	{
+		return;
+	}
+
+	//the loose cube of a child lies inside its parent's, the root's has no bounds
+	if (a_uLevel > 0)
+	{
+		float fCell = m_fSize / static_cast<float>(1 << a_uLevel);
+		float fMargin = (m_fLooseness - 1.0f) * fCell / 2.0f;
+		vector3 v3LooseMin = m_v3Min + vector3(a_uX, a_uY, a_uZ) * fCell - vector3(fMargin);
+		vector3 v3LooseMax = v3LooseMin + vector3(fCell + 2.0f * fMargin);
+		if (v3LooseMax.x < a_v3Min.x || v3LooseMin.x > a_v3Max.x ||
+			v3LooseMax.y < a_v3Min.y || v3LooseMin.y > a_v3Max.y ||
+			v3LooseMax.z < a_v3Min.z || v3LooseMin.z > a_v3Max.z)
+		{
+			return;
+		}
+	}
+
+	for (uint uEntity = m_lHead[uOctant]; uEntity != static_cast<uint>(-1); uEntity = m_lNext[uEntity])
+	{
+		a_lEntity.push_back(uEntity);
+	}
+
+	if (a_uLevel == m_uMaxLevel)
+	{
+		return;
+	}
+	for (uint k = 0; k < 8; k++)
+	{
+		CollectCandidates(a_uLevel + 1, 2 * a_uX + (k & 1), 2 * a_uY + ((k >> 1) & 1), 2 * a_uZ + (k >> 2), a_v3Min, a_v3Max, a_lEntity);
+	}
+}
+
+void MyLooseOctree::Display(uint a_nIndex, vector3 a_v3Color)
+{
+	if (a_nIndex >= m_lHead.size())
+	{
+		return;
+	}
+	uint uLevel, uX, uY, uZ;
+	DecodeOctant(a_nIndex, uLevel, uX, uY, uZ);
+	float fCell = m_fSize / static_cast<float>(1 << uLevel);
+	vector3 v3Center = m_v3Min + (vector3(uX, uY, uZ) + vector3(0.5f)) * fCell;
+	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, v3Center) * glm::scale(vector3(fCell * m_fLooseness)), a_v3Color, RENDER_WIRE);
+}
+
+void MyLooseOctree::Display(vector3 a_v3Color)
+{
+	for (uint i = 0; i < m_lHead.size(); i++)
+	{
+		if (m_lHead[i] != static_cast<uint>(-1))
+		{
+			Display(i, a_v3Color);
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#ifndef MYLOOSEOCTREECLASS_H
+#define MYLOOSEOCTREECLASS_H
+
+#include "MyEntityManager.h"
+
+using namespace Simplex;
+
+class MyLooseOctree
+{
+	static const uint m_uLevelCap = 5; // Deepest level the octant arrays are allowed to reach
+
+	uint m_uMaxLevel = 0; // Max level of subdivision
+	float m_fLooseness = 2.0f; // Size of the loose cube of each octant relative to the octant
+
+	MeshManager* m_pMeshMngr = nullptr;
+	MyEntityManager* m_pEntityMngr = nullptr;
+
+	vector3 m_v3Min = vector3(0.0f); // Minimum of the root in global space
+	vector3 m_v3Max = vector3(0.0f); // Maximum of the root in global space
+	vector3 m_v3Center = vector3(0.0f); // Center of the root in global space
+	float m_fSize = 0.0f; // Size of the root
+
+	std::vector<uint> m_lLevelOffset; // Index of the first octant of each level, a level is stored x first, then y, then z
+	std::vector<uint> m_lHead; // First entity stored in each octant, -1 if none
+	std::vector<uint> m_lSubtreeCount; // Entities stored in each octant and its descendants
+
+	std::vector<uint> m_lEntityOctant; // Octant each entity (index in the Entity Manager) is stored in, -1 if not stored yet
+	std::vector<uint> m_lNext; // Next entity stored in the same octant, -1 at the end
+	std::vector<uint> m_lPrev; // Previous entity stored in the same octant, -1 at the start
+	uint m_uEntityCount = 0; // Number of entity indices the tree follows
+	uint m_uRelocated = 0; // Entities that changed octant in the last UpdateEntities
+
+public:
+	/*
+	USAGE: Constructor, will create a loose octree with the entities the Entity Manager
+	currently contains
+	ARGUMENTS:
+	- uint a_nMaxLevel = 2 -> Sets the maximum level of subdivision
+	- float a_fLooseness = 2.0f -> Size of the loose cube of each octant relative to the
+	octant (at least 1, where the octree is no longer loose)
+	OUTPUT: class object
+	*/
+	MyLooseOctree(uint a_nMaxLevel = 2, float a_fLooseness = 2.0f);
+	/*
+	USAGE: Copy Constructor
+	ARGUMENTS: class object to copy
+	OUTPUT: class object instance
+	*/
+	MyLooseOctree(MyLooseOctree const& other);
+	/*
+	USAGE: Copy Assignment Operator
+	ARGUMENTS: class object to copy
+	OUTPUT: ---
+	*/
+	MyLooseOctree& operator=(MyLooseOctree const& other);
+	/*
+	USAGE: Destructor
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	~MyLooseOctree(void);
+	/*
+	USAGE: Changes object contents for other object's
+	ARGUMENTS:
+	- MyLooseOctree& other -> object to swap content from
+	OUTPUT: ---
+	*/
+	void Swap(MyLooseOctree& other);
+	/*
+	USAGE: Rebuilds the tree from the current position of the entities: fits the root around
+	them and stores each one in the deepest octant whose loose cube holds its box
+	ARGUMENTS:
+	- uint a_nMaxLevel = 3 -> Sets the maximum level of the tree (at most 5)
+	OUTPUT: ---
+	*/
+	void ConstructTree(uint a_nMaxLevel = 3);
+	/*
+	USAGE: Moves the entities whose global bounding box changed to the octant that now
+	fits them, most moves stay inside the loose cube and cost nothing. The entities added
+	since the last update are stored as well
+	ARGUMENTS:
+	- std::vector<uint> const& a_lEntity -> Index in the Entity Manager of the moved entities
+	OUTPUT: ---
+	*/
+	void UpdateEntities(std::vector<uint> const& a_lEntity);
+	/*
+	USAGE: Takes the entity out of the tree before the Entity Manager removes it, the last
+	entity is moved to its index the same way the manager swaps them
+	ARGUMENTS: uint a_uIndex -> index of the entity in the Entity Manager
+	OUTPUT: ---
+	*/
+	void RemoveEntity(uint a_uIndex);
+	/*
+	USAGE: Appends the entities stored in every octant whose loose cube overlaps the box,
+	a superset of the entities whose own boxes overlap it. Only reads the tree, so several
+	threads can ask at once
+	ARGUMENTS:
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- std::vector<uint>& a_lEntity -> list to append the entities (index in the Entity Manager) to
+	OUTPUT: ---
+	*/
+	void GetCandidates(vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lEntity);
+	/*
+	USAGE: Gets the max level of subdivision of the tree
+	ARGUMENTS: ---
+	OUTPUT: max level
+	*/
+	uint GetMaxLevel(void);
+	/*
+	USAGE: Gets the size of the loose cube of each octant relative to the octant
+	ARGUMENTS: ---
+	OUTPUT: looseness
+	*/
+	float GetLooseness(void);
+	/*
+	USAGE: Gets the total number of octants in the tree
+	ARGUMENTS: ---
+	OUTPUT: octant count
+	*/
+	uint GetOctantCount(void);
+	/*
+	USAGE: Gets the ID of the octant the entity specified by index is stored in
+	ARGUMENTS: uint a_uIndex -> index of the entity in the Entity Manager
+	OUTPUT: ID of the octant, -1 if out of bounds
+	*/
+	uint GetEntityOctant(uint a_uIndex);
+	/*
+	USAGE: Gets the number of entities that changed octant in the last UpdateEntities
+	ARGUMENTS: ---
+	OUTPUT: relocated entities
+	*/
+	uint GetRelocatedCount(void);
+	/*
+	USAGE: Displays the loose cube of the octant specified by ID
+	ARGUMENTS:
+	- uint a_nIndex -> Octant to be displayed.
+	- vector3 a_v3Color = C_YELLOW -> Color of the volume to display.
+	OUTPUT: ---
+	*/
+	void Display(uint a_nIndex, vector3 a_v3Color = C_YELLOW);
+	/*
+	USAGE: Displays the loose cube of every octant that stores entities
+	ARGUMENTS:
+	- vector3 a_v3Color = C_YELLOW -> Color of the volume to display.
+	OUTPUT: ---
+	*/
+	void Display(vector3 a_v3Color = C_YELLOW);
+
+private:
+	/*
+	USAGE: Deallocates member fields
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Release(void);
+	/*
+	USAGE: Allocates member fields
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Init(void);
+	/*
+	USAGE: Fits the root cube around the global bounding box of every entity
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void ComputeBounds(void);
+	/*
+	USAGE: Gets the index of the octant of a level from its cell along each axis
+	ARGUMENTS:
+	- uint a_uLevel -> level of the octant
+	- uint a_uX, a_uY, a_uZ -> cell of the octant along each axis
+	OUTPUT: index of the octant
+	*/
+	uint GetOctantIndex(uint a_uLevel, uint a_uX, uint a_uY, uint a_uZ);
+	/*
+	USAGE: Gets the level and the cell along each axis of the octant specified by index
+	ARGUMENTS:
+	- uint a_uOctant -> index of the octant
+	- uint& a_uLevel -> level of the octant
+	- uint& a_uX, a_uY, a_uZ -> cell of the octant along each axis
+	OUTPUT: ---
+	*/
+	void DecodeOctant(uint a_uOctant, uint& a_uLevel, uint& a_uX, uint& a_uY, uint& a_uZ);
+	/*
+	USAGE: Finds the deepest octant whose loose cube holds the box, by its center
+	ARGUMENTS:
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	OUTPUT: index of the octant, the root if no other holds it
+	*/
+	uint FindOctant(vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: Stores the entity in the octant, counting it in the octant and its ancestors
+	ARGUMENTS:
+	- uint a_uEntity -> index of the entity in the Entity Manager
+	- uint a_uOctant -> index of the octant
+	OUTPUT: ---
+	*/
+	void Link(uint a_uEntity, uint a_uOctant);
+	/*
+	USAGE: Takes the entity out of the octant it is stored in
+	ARGUMENTS: uint a_uEntity -> index of the entity in the Entity Manager
+	OUTPUT: ---
+	*/
+	void Unlink(uint a_uEntity);
+	/*
+	USAGE: Appends the entities of the octant and of its descendants whose loose cube
+	overlaps the box, skipping the branches that store nothing
+	ARGUMENTS:
+	- uint a_uLevel -> level of the octant
+	- uint a_uX, a_uY, a_uZ -> cell of the octant along each axis
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- std::vector<uint>& a_lEntity -> list to append the entities to
+	OUTPUT: ---
+	*/
+	void CollectCandidates(uint a_uLevel, uint a_uX, uint a_uY, uint a_uZ, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lEntity);
+};
+
+#endif
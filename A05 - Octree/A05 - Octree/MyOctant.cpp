@@ -1,122 +1,51 @@
 #include "MyOctant.h"
+#include "MyThreadPool.h"
 using namespace Simplex;
 
-uint MyOctant::m_uOctantCount = 0;
-uint MyOctant::m_uMaxLevel = 3;
-uint MyOctant::m_uIdealEntityCount = 5;
+bool MyOctant::m_bParallelBuild = false;
+uint MyOctant::m_uTaskLevel = 2;
 
 void MyOctant::Init()
 {
-	m_uID = m_uOctantCount;
-	m_uLevel = 0;
-	m_uChildren = 0;
-	m_fSize = 0.0f;
-
-	m_v3Center = vector3(0.0f);
-	m_v3Min = vector3(0.0f);
-	m_v3Max = vector3(0.0f);
+	m_uMaxLevel = 0;
+	m_uIdealEntityCount = 5;
 
 	m_pMeshMngr = MeshManager::GetInstance();
 	m_pEntityMngr = MyEntityManager::GetInstance();
 
-	m_pRoot = nullptr;
-	m_pParent = nullptr;
-
-	for (uint i = 0; i < 8; i++) 
-	{
-		m_pChild[i] = nullptr;
-	}
+	//the root is always there, even before the first build
+	m_lNode.assign(1, Node());
+	m_lNodeEntity.resize(1);
+	m_uQueryStamp = 0;
+	m_uStoreVersion = 0;
 }
 
-MyOctant::MyOctant(uint a_nMaxLevel, uint a_nIdealEntityCount) 
+MyOctant::MyOctant(uint a_nMaxLevel, uint a_nIdealEntityCount)
 {
 	Init();
-
-	m_uOctantCount = 0;
-	m_uMaxLevel = a_nMaxLevel;
 	m_uIdealEntityCount = a_nIdealEntityCount;
-	m_uID = m_uOctantCount;
-
-	m_pRoot = this;
-	m_lChild.clear();
-
-	std::vector<vector3> lMinMax;
-
-	uint nObjects = m_pEntityMngr->GetEntityCount();
-
-	for (int i = 0; i < nObjects; i++) 
-	{
-		MyEntity* pEntity = m_pEntityMngr->GetEntity(i);
-		MyRigidBody* pRigidBody = pEntity->GetRigidBody();
-		lMinMax.push_back(pRigidBody->GetMinGlobal());
-		lMinMax.push_back(pRigidBody->GetMaxGlobal());
-	}
-	MyRigidBody* pRigidBody = new MyRigidBody(lMinMax);
-
-	vector3 vHalfWidth = pRigidBody->GetHalfWidth();
-	float fMax = vHalfWidth.x;
-	for (int i = 1; i < 3; i++) 
-	{
-		if (fMax < vHalfWidth[i]) 
-		{
-			fMax = vHalfWidth[i];
-		}
-	}
-
-	vector3 v3Center = pRigidBody->GetCenterLocal();
-	lMinMax.clear();
-	SafeDelete(pRigidBody);
-
-	m_fSize = fMax * 2.0f;
-	m_v3Center = v3Center;
-	m_v3Min = m_v3Center - (vector3(fMax));
-	m_v3Max = m_v3Center + (vector3(fMax));
-
-	m_uOctantCount++;
-
-	ConstructTree(m_uMaxLevel);
-}
-MyOctant::MyOctant(vector3 a_v3Center, float a_fSize)
-{
-
-	Init();
-	m_v3Center = a_v3Center;
-	m_fSize = a_fSize;
-
-	m_v3Min = m_v3Center - (vector3(m_fSize) / 2.0f);
-	m_v3Max = m_v3Center + (vector3(m_fSize) / 2.0f);
-
-	m_uOctantCount++;
+	ConstructTree(a_nMaxLevel);
 }
 
 MyOctant::MyOctant(MyOctant const& other)
 {
-	m_uChildren = other.m_uChildren;
-	m_v3Max = other.m_v3Max;
-	m_v3Center = other.m_v3Center;
-	m_v3Min = other.m_v3Min;
-
-	m_fSize = other.m_fSize;
-	m_uID = other.m_uID;
-	m_uLevel = other.m_uLevel;
-	m_pParent = other.m_pParent;
-
-	m_pRoot = other.m_pRoot;
-	m_lChild = other.m_lChild;
-
+	m_uMaxLevel = other.m_uMaxLevel;
+	m_uIdealEntityCount = other.m_uIdealEntityCount;
 
 	m_pMeshMngr = MeshManager::GetInstance();
 	m_pEntityMngr = MyEntityManager::GetInstance();
 
-	for (int i = 0; i < 8; i++) 
-	{
-		m_pChild[i] = other.m_pChild[i];
-	}
+	m_lNode = other.m_lNode;
+	m_lNodeEntity = other.m_lNodeEntity;
+	m_lFreeBrood = other.m_lFreeBrood;
+	m_lLeaf = other.m_lLeaf;
+	m_uQueryStamp = 0;
+	m_uStoreVersion = other.m_uStoreVersion;
 }
 
-MyOctant& MyOctant::operator=(MyOctant const& other) 
+MyOctant& MyOctant::operator=(MyOctant const& other)
 {
-	if (this != &other) 
+	if (this != &other)
 	{
 		Release();
 		Init();
@@ -126,113 +55,126 @@ MyOctant& MyOctant::operator=(MyOctant const& other)
 	return *this;
 }
 
-MyOctant::~MyOctant() 
+MyOctant::~MyOctant()
 {
 	Release();
 }
 
 void MyOctant::Release()
 {
-	if (m_uLevel == 0) 
-	{
-		KillBranches();
-	}
-
-	m_uOctantCount = 0;
-	m_uChildren = 0;
-	m_fSize = 0.0f;
-	m_lEntityList.clear();
-	m_lChild.clear();
+	//the whole tree lives in the pool, it goes away in one go
+	m_lNode.clear();
+	m_lNodeEntity.clear();
+	m_lFreeBrood.clear();
+	m_lLeaf.clear();
+	m_lTask.clear();
+	m_lTaskRange.clear();
+	m_lQueryMark.clear();
+	m_uQueryStamp = 0;
 }
 
 void MyOctant::Swap(MyOctant& other)
 {
-	std::swap(m_uChildren, other.m_uChildren);
-	std::swap(m_fSize, other.m_fSize);
-	std::swap(m_uID, other.m_uID);
-	std::swap(m_pRoot, other.m_pRoot);
-	std::swap(m_lChild, other.m_lChild);
-	std::swap(m_v3Center, other.m_v3Center);
-	std::swap(m_v3Min, other.m_v3Min);
-	std::swap(m_v3Max, other.m_v3Max);
+	std::swap(m_uMaxLevel, other.m_uMaxLevel);
+	std::swap(m_uIdealEntityCount, other.m_uIdealEntityCount);
+	std::swap(m_lNode, other.m_lNode);
+	std::swap(m_lNodeEntity, other.m_lNodeEntity);
+	std::swap(m_lFreeBrood, other.m_lFreeBrood);
+	std::swap(m_lLeaf, other.m_lLeaf);
+	std::swap(m_lTask, other.m_lTask);
+	std::swap(m_lTaskRange, other.m_lTaskRange);
+	std::swap(m_lQueryMark, other.m_lQueryMark);
+	std::swap(m_uQueryStamp, other.m_uQueryStamp);
+	std::swap(m_uStoreVersion, other.m_uStoreVersion);
 	m_pMeshMngr = MeshManager::GetInstance();
 	m_pEntityMngr = MyEntityManager::GetInstance();
-	std::swap(m_uLevel, other.m_uLevel);
-	std::swap(m_pParent, other.m_pParent);
-	for (int i = 0; i < 8; i++) 
-	{
-		std::swap(m_pChild[i], other.m_pChild[i]);
-	}
 }
 
-float MyOctant::GetSize() 
+float MyOctant::GetSize()
 {
-	return m_fSize;
+	return m_lNode[0].m_fSize;
 }
-vector3 MyOctant::GetCenterGlobal() 
+vector3 MyOctant::GetCenterGlobal()
 {
-	return m_v3Center;
+	return m_lNode[0].m_v3Center;
 }
-vector3 MyOctant::GetMinGlobal() 
+vector3 MyOctant::GetMinGlobal()
 {
-	return m_v3Min;
+	return m_lNode[0].m_v3Min;
 }
-vector3 MyOctant::GetMaxGlobal() 
+vector3 MyOctant::GetMaxGlobal()
 {
-	return m_v3Max;
+	return m_lNode[0].m_v3Max;
+}
+uint MyOctant::GetMaxLevel()
+{
+	return m_uMaxLevel;
 }
 uint MyOctant::GetOctantCount()
 {
-	return m_uOctantCount;
+	return m_lNode.size();
 }
 
-MyOctant* MyOctant::GetParent()
+uint MyOctant::GetLeafCount()
 {
-	return m_pParent;
+	return m_lLeaf.size();
 }
 
-bool MyOctant::IsLeaf()
+uint MyOctant::GetLeafID(uint a_uIndex)
 {
-	return m_uChildren == 0;
+	if (a_uIndex >= m_lLeaf.size())
+	{
+		return -1;
+	}
+	return m_lLeaf[a_uIndex];
 }
 
-bool MyOctant::IsColliding(uint a_uRBIndex) 
+uint MyOctant::GetLeafEntityCount(uint a_uIndex)
 {
-	int nObjectCount = m_pEntityMngr->GetEntityCount();
-	if (a_uRBIndex >= nObjectCount) 
+	if (a_uIndex >= m_lLeaf.size())
 	{
-		return false;
+		return 0;
 	}
+	return m_lNodeEntity[m_lLeaf[a_uIndex]].size();
+}
 
-	MyEntity* pEntity = m_pEntityMngr->GetEntity(a_uRBIndex);
-	MyRigidBody* pRigidBody = pEntity->GetRigidBody();
-	vector3 v3MinO = pRigidBody->GetMinGlobal();
-	vector3 v3MaxO = pRigidBody->GetMaxGlobal();
+uint const* MyOctant::GetLeafEntityList(uint a_uIndex)
+{
+	if (a_uIndex >= m_lLeaf.size())
+	{
+		return nullptr;
+	}
+	return m_lNodeEntity[m_lLeaf[a_uIndex]].data();
+}
+
+bool MyOctant::IsColliding(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	Node const& node = m_lNode[a_uNode];
 
 	//AABB
-	if (m_v3Max.x < v3MinO.x) 
+	if (node.m_v3Max.x < a_v3Min.x)
 	{
 		return false;
 	}
-	if (m_v3Min.x > v3MaxO.x) 
+	if (node.m_v3Min.x > a_v3Max.x)
 	{
 		return false;
 	}
 
-	if (m_v3Max.y < v3MinO.y) 
+	if (node.m_v3Max.y < a_v3Min.y)
 	{
 		return false;
 	}
-	if (m_v3Min.y > v3MaxO.y) 
+	if (node.m_v3Min.y > a_v3Max.y)
 	{
 		return false;
 	}
 
-	if (m_v3Max.z < v3MinO.z) 
+	if (node.m_v3Max.z < a_v3Min.z)
 	{
 		return false;
 	}
-	if (m_v3Min.z > v3MaxO.z) 
+	if (node.m_v3Min.z > a_v3Max.z)
 	{
 		return false;
 	}
@@ -240,193 +182,885 @@ bool MyOctant::IsColliding(uint a_uRBIndex)
 	return true;
 }
 
-void MyOctant::Display(uint a_nIndex, vector3 a_v3Color) 
+void MyOctant::Display(uint a_nIndex, vector3 a_v3Color)
 {
-	if (m_uID == a_nIndex) 
+	if (!IsInTree(a_nIndex))
 	{
-		m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
 		return;
 	}
-	for (int i = 0; i < m_uChildren; i++) 
-	{
-		m_pChild[i]->Display(a_nIndex);
-	}
+	Node const& node = m_lNode[a_nIndex];
+	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, node.m_v3Center) * glm::scale(vector3(node.m_fSize)), a_v3Color, RENDER_WIRE);
 }
 
-void MyOctant::Display(vector3 a_v3Color) 
+void MyOctant::Display(vector3 a_v3Color)
 {
-	for (int i = 0; i < m_uChildren; i++) 
+	for (uint i = 0; i < m_lNode.size(); i++)
 	{
-		m_pChild[i]->Display(a_v3Color);
+		Display(i, a_v3Color);
 	}
-	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
 }
 
-void MyOctant::DisplayLeafs(vector3 a_v3Color) 
+void MyOctant::DisplayLeafs(vector3 a_v3Color)
 {
-	int nLeafs = m_lChild.size();
-	for (int i = 0; i < nLeafs; i++) 
+	for (uint i = 0; i < m_lLeaf.size(); i++)
 	{
-		m_lChild[i]->DisplayLeafs(a_v3Color);
+		Display(m_lLeaf[i], a_v3Color);
 	}
-	m_pMeshMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) * glm::scale(vector3(m_fSize)), a_v3Color, RENDER_WIRE);
 }
 
-void MyOctant::Subdivide() 
+void MyOctant::CreateChildren(uint a_uNode, BroodRange* a_pRange)
 {
-	if (m_uLevel >= m_uMaxLevel || m_uChildren != 0) 
+	uint uFirst = static_cast<uint>(-1);
+	if (a_pRange == nullptr)
+	{
+		uFirst = AllocateBrood();
+	}
+	else
+	{
+		//the slice belongs to a single task, only refilling it touches the shared counter;
+		//near the end of the pool a single brood is taken so no slot is left unused
+		if (a_pRange->m_uNext + 8 > a_pRange->m_uEnd)
+		{
+			uint uStart = a_pRange->m_pPoolNext->load();
+			uint uSize = 0;
+			do
+			{
+				uSize = uStart + m_uTaskChunk <= a_pRange->m_uPoolEnd ? m_uTaskChunk : (uStart + 8 <= a_pRange->m_uPoolEnd ? 8 : 0);
+			} while (uSize > 0 && !a_pRange->m_pPoolNext->compare_exchange_weak(uStart, uStart + uSize));
+			if (uSize > 0)
+			{
+				//what was left of the old chunk is given back with the rest after the build
+				a_pRange->m_uNext = uStart;
+				a_pRange->m_uEnd = uStart + uSize;
+			}
+		}
+		if (a_pRange->m_uNext + 8 <= a_pRange->m_uEnd)
+		{
+			uFirst = a_pRange->m_uNext;
+			a_pRange->m_uNext += 8;
+		}
+	}
+	if (uFirst == static_cast<uint>(-1))
 	{
 		return;
 	}
-	m_uChildren = 8;
 
-	float childHalf = m_fSize / 4.0f;
-	float childSize = m_fSize / 2.0f;
-	vector3 center = m_v3Center;
+	//the pool might have grown, the octant is only looked up once the slots are taken
+	Node& node = m_lNode[a_uNode];
+	float childHalf = node.m_fSize / 4.0f;
+	float childSize = node.m_fSize / 2.0f;
+	vector3 v3Center[8];
+	vector3 center = node.m_v3Center;
 	center.x -= childHalf;
 	center.y -= childHalf;
 	center.z -= childHalf;
 
 	//bacon lettuce bacon
-	m_pChild[0] = new MyOctant(center, childSize);
+	v3Center[0] = center;
 
 	//bacon ranch bacon
 	center.x += childSize;
-	m_pChild[1] = new MyOctant(center, childSize);
+	v3Center[1] = center;
 
 	//bacon ranch flatbread
 	center.z += childSize;
-	m_pChild[2] = new MyOctant(center, childSize);
+	v3Center[2] = center;
 
 	//bacon lettuce flatbread
 	center.x -= childSize;
-	m_pChild[3] = new MyOctant(center, childSize);
+	v3Center[3] = center;
 
 	//tomato lettuce flatbread
 	center.y += childSize;
-	m_pChild[4] = new MyOctant(center, childSize);
+	v3Center[4] = center;
 
 	//tomato lettuce bacon
 	center.z -= childSize;
-	m_pChild[5] = new MyOctant(center, childSize);
+	v3Center[5] = center;
 
 	//tomato ranch bacon
 	center.x += childSize;
-	m_pChild[6] = new MyOctant(center, childSize);
+	v3Center[6] = center;
 
 	//tomato ranch flatbread
 	center.z += childSize;
-	m_pChild[7] = new MyOctant(center, childSize);
+	v3Center[7] = center;
+
+	node.m_uFirstChild = uFirst;
+	node.m_uChildren = 8;
+	for (uint i = 0; i < 8; i++)
+	{
+		//recycled slots keep the capacity of their entity lists
+		Node& child = m_lNode[uFirst + i];
+		child.m_v3Center = v3Center[i];
+		child.m_fSize = childSize;
+		child.m_v3Min = v3Center[i] - vector3(childSize / 2.0f);
+		child.m_v3Max = v3Center[i] + vector3(childSize / 2.0f);
+		child.m_uLevel = node.m_uLevel + 1;
+		child.m_uParent = a_uNode;
+		child.m_uFirstChild = 0;
+		child.m_uChildren = 0;
+		child.m_bInUse = true;
+		m_lNodeEntity[uFirst + i].clear();
+	}
+}
+
+uint MyOctant::AllocateBrood()
+{
+	uint uFirst = 0;
+	if (m_lFreeBrood.size() > 0)
+	{
+		uFirst = m_lFreeBrood.back();
+		m_lFreeBrood.pop_back();
+		return uFirst;
+	}
+
+	//octants are reached by index, so the pool is free to grow
+	uFirst = m_lNode.size();
+	m_lNode.resize(uFirst + 8);
+	if (m_lNodeEntity.size() < m_lNode.size())
+	{
+		m_lNodeEntity.resize(m_lNode.size());
+	}
+	return uFirst;
+}
+
+bool MyOctant::IsInTree(uint a_uID)
+{
+	return a_uID < m_lNode.size() && m_lNode[a_uID].m_bInUse;
+}
 
-	for (int i = 0; i < 8; i++) 
+void MyOctant::KillBranches(uint a_uNode)
+{
+	if (m_lNode[a_uNode].m_uChildren == 0)
 	{
-		m_pChild[i]->m_pRoot = m_pRoot;
-		m_pChild[i]->m_pParent = this;
-		m_pChild[i]->m_uLevel = m_uLevel + 1;
-		m_pChild[i]->m_uIdealEntityCount = m_uIdealEntityCount;
+		return;
+	}
 
-		if (m_pChild[i]->CheckObjectCount(m_uIdealEntityCount) && m_pChild[i]->m_uLevel < m_uMaxLevel) 
+	//remove all child branches, their slots go back to the pool
+	uint uFirst = m_lNode[a_uNode].m_uFirstChild;
+	for (uint i = 0; i < 8; i++)
+	{
+		KillBranches(uFirst + i);
+		m_lNodeEntity[uFirst + i].clear();
+		m_lNode[uFirst + i].m_bInUse = false;
+	}
+	m_lFreeBrood.push_back(uFirst);
+	m_lNode[a_uNode].m_uChildren = 0;
+}
+
+void MyOctant::ConstructTree(uint a_nMaxLevel)
+{
+	m_uMaxLevel = a_nMaxLevel;
+
+	//one bulk reset instead of releasing the octants one by one, the entity lists of the
+	//pool keep their capacity for the next build
+	m_lNode.resize(1);
+	m_lNode[0] = Node();
+	m_lFreeBrood.clear();
+	m_lLeaf.clear();
+	ComputeBounds();
+
+	//dimensions from a previous tree would point to octants that no longer exist
+	m_pEntityMngr->ClearDimensionSetAll();
+
+	//the root was sized around every entity, so all of them start here
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	std::vector<uint>& lRoot = m_lNodeEntity[0];
+	lRoot.resize(nObjects);
+	for (uint i = 0; i < nObjects; i++)
+	{
+		lRoot[i] = i;
+	}
+	//the pool of a parallel build is only sized for trees up to the level cap, deeper ones
+	//are built on this thread so they always come out the same
+	if (m_bParallelBuild && m_uTaskLevel < m_uMaxLevel && m_uMaxLevel <= m_uParallelLevelCap)
+	{
+		DistributeParallel();
+	}
+	else
+	{
+		Distribute(0);
+	}
+	ConstructList(0);
+	m_uStoreVersion = m_pEntityMngr->GetAABBStore()->GetVersion();
+}
+
+void MyOctant::ComputeBounds()
+{
+	Node& root = m_lNode[0];
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (nObjects == 0)
+	{
+		root.m_v3Min = root.m_v3Max = root.m_v3Center = vector3(0.0f);
+		root.m_fSize = 0.0f;
+		return;
+	}
+
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	vector3 v3Min = pStore->GetMin(0);
+	vector3 v3Max = pStore->GetMax(0);
+	for (uint i = 1; i < nObjects; i++)
+	{
+		v3Min = glm::min(v3Min, pStore->GetMin(i));
+		v3Max = glm::max(v3Max, pStore->GetMax(i));
+	}
+
+	vector3 vHalfWidth = (v3Max - v3Min) / 2.0f;
+	float fMax = std::max(vHalfWidth.x, std::max(vHalfWidth.y, vHalfWidth.z));
+
+	root.m_fSize = fMax * 2.0f;
+	root.m_v3Center = (v3Max + v3Min) / 2.0f;
+	root.m_v3Min = root.m_v3Center - vector3(fMax);
+	root.m_v3Max = root.m_v3Center + vector3(fMax);
+}
+
+void MyOctant::DistributeParallel()
+{
+	//the octants of the task level that need to be split are left in the task list
+	m_lTask.clear();
+	Distribute(0, nullptr, &m_lTask);
+	if (m_lTask.size() == 0)
+	{
+		return;
+	}
+
+	//the tasks take their octants from the rest of the pool, which cannot grow while they
+	//run: it is sized for a full tree plus most of a chunk per task, as every task can leave
+	//its last one unused
+	uint uPoolUsed = m_lNode.size();
+	uint uPoolEnd = 1;
+	uint uLevelSize = 1;
+	for (uint i = 0; i < m_uMaxLevel; i++)
+	{
+		uLevelSize *= 8;
+		uPoolEnd += uLevelSize;
+	}
+	uPoolEnd = std::max(uPoolEnd, uPoolUsed) + m_lTask.size() * (m_uTaskChunk - 8);
+	m_lNode.resize(uPoolEnd);
+	if (m_lNodeEntity.size() < uPoolEnd)
+	{
+		m_lNodeEntity.resize(uPoolEnd);
+	}
+
+	std::atomic<uint> uPoolNext(uPoolUsed);
+	m_lTaskRange.resize(m_lTask.size());
+	for (uint i = 0; i < m_lTask.size(); i++)
+	{
+		m_lTaskRange[i] = BroodRange();
+		m_lTaskRange[i].m_pPoolNext = &uPoolNext;
+		m_lTaskRange[i].m_uPoolEnd = uPoolEnd;
+	}
+
+	//each task only writes to its own subtree
+	MyThreadPool::GetInstance()->ParallelFor(m_lTask.size(), [this](uint a_uTask, uint a_uThread)
+	{
+		Distribute(m_lTask[a_uTask], &m_lTaskRange[a_uTask]);
+	});
+
+	//the slots no task took are dropped
+	m_lNode.resize(uPoolNext.load());
+	for (uint i = 0; i < m_lTask.size(); i++)
+	{
+		//what a task did not use of its last chunk goes back to the pool for the updates
+		for (uint uSlot = m_lTaskRange[i].m_uNext; uSlot < m_lTaskRange[i].m_uEnd; uSlot += 8)
 		{
-			m_pChild[i]->Subdivide();
+			for (uint j = 0; j < 8; j++)
+			{
+				m_lNode[uSlot + j].m_bInUse = false;
+				m_lNodeEntity[uSlot + j].clear();
+			}
+			m_lFreeBrood.push_back(uSlot);
 		}
+		//an entity can live in the leafs of several tasks, so only this thread tags them
+		TagLeafs(m_lTask[i]);
 	}
+	m_lTask.clear();
 }
 
-MyOctant* MyOctant::GetChild(uint a_nChild)
+void MyOctant::TagLeafs(uint a_uNode)
 {
-	if (a_nChild > 7) 
+	Node const& node = m_lNode[a_uNode];
+	for (uint i = 0; i < node.m_uChildren; i++)
 	{
-		return nullptr;
+		TagLeafs(node.m_uFirstChild + i);
+	}
+	if (node.m_uChildren == 0)
+	{
+		std::vector<uint> const& lEntity = m_lNodeEntity[a_uNode];
+		for (uint i = 0; i < lEntity.size(); i++)
+		{
+			m_pEntityMngr->AddDimension(lEntity[i], a_uNode);
+		}
+	}
+}
+
+void MyOctant::SetParallelBuild(bool a_bParallel, uint a_uTaskLevel)
+{
+	m_bParallelBuild = a_bParallel;
+	//the root as the only task would build the whole tree on one thread
+	m_uTaskLevel = std::max(a_uTaskLevel, 1u);
+}
+
+bool MyOctant::GetParallelBuild(void) { return m_bParallelBuild; }
+
+bool MyOctant::CheckParallelBuild(void)
+{
+	bool bParallel = m_bParallelBuild;
+	m_bParallelBuild = false;
+	MyOctant serial(m_uMaxLevel, m_uIdealEntityCount);
+	m_bParallelBuild = true;
+	ConstructTree(m_uMaxLevel);
+	m_bParallelBuild = bParallel;
+
+	//node IDs depend on the order the tasks took their slots, the leafs themselves do not
+	bool bSame = m_lLeaf.size() == serial.m_lLeaf.size();
+	for (uint i = 0; bSame && i < m_lLeaf.size(); i++)
+	{
+		Node const& leaf = m_lNode[m_lLeaf[i]];
+		Node const& other = serial.m_lNode[serial.m_lLeaf[i]];
+		bSame = leaf.m_uLevel == other.m_uLevel &&
+			leaf.m_v3Min == other.m_v3Min && leaf.m_v3Max == other.m_v3Max &&
+			m_lNodeEntity[m_lLeaf[i]] == serial.m_lNodeEntity[serial.m_lLeaf[i]];
+	}
+
+	//the tags are left for whichever build this tree keeps
+	if (!bParallel)
+	{
+		ConstructTree(m_uMaxLevel);
+	}
+	return bSame;
+}
+
+void MyOctant::ConstructList(uint a_uNode)
+{
+	Node const& node = m_lNode[a_uNode];
+	for (uint i = 0; i < node.m_uChildren; i++)
+	{
+		ConstructList(node.m_uFirstChild + i);
+	}
+
+	if (m_lNodeEntity[a_uNode].size() > 0)
+	{
+		m_lLeaf.push_back(a_uNode);
+	}
+}
+
+void MyOctant::CollectLeafs(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lLeaf)
+{
+	if (!IsColliding(a_uNode, a_v3Min, a_v3Max))
+	{
+		return;
+	}
+	Node const& node = m_lNode[a_uNode];
+	if (node.m_uChildren == 0)
+	{
+		a_lLeaf.push_back(a_uNode);
+		return;
+	}
+	for (uint i = 0; i < node.m_uChildren; i++)
+	{
+		CollectLeafs(node.m_uFirstChild + i, a_v3Min, a_v3Max, a_lLeaf);
 	}
-	return m_lChild[a_nChild];
 }
 
-bool MyOctant::CheckObjectCount(uint a_nEntities)
+void MyOctant::Distribute(uint a_uNode, BroodRange* a_pRange, std::vector<uint>* a_pTaskList)
 {
-	int count = 0;
-	int entityCount = m_pEntityMngr->GetEntityCount();
-	for (int i = 0; i < entityCount; i++) 
+	//the root always subdivides, the rest only when over the ideal count
+	uint uLevel = m_lNode[a_uNode].m_uLevel;
+	bool bLeaf = uLevel >= m_uMaxLevel || (uLevel > 0 && m_lNodeEntity[a_uNode].size() <= m_uIdealEntityCount);
+	if (!bLeaf && a_pTaskList != nullptr && uLevel >= m_uTaskLevel)
+	{
+		a_pTaskList->push_back(a_uNode);
+		return;
+	}
+	if (!bLeaf)
+	{
+		CreateChildren(a_uNode, a_pRange);
+		//only a parallel build can run out of slots, and not while its pool holds a full tree
+		bLeaf = m_lNode[a_uNode].m_uChildren == 0;
+	}
+	if (bLeaf)
+	{
+		//a task leaves the tagging to the thread that started the build
+		if (a_pRange == nullptr)
+		{
+			std::vector<uint> const& lEntity = m_lNodeEntity[a_uNode];
+			for (uint i = 0; i < lEntity.size(); i++)
+			{
+				m_pEntityMngr->AddDimension(lEntity[i], a_uNode);
+			}
+		}
+		return;
+	}
+
+	//siblings are contiguous in the pool
+	uint uFirst = m_lNode[a_uNode].m_uFirstChild;
+
+	//each child scans the list on its own, above the task level they do it in parallel
+	if (a_pTaskList != nullptr)
 	{
-		if (IsColliding(i)) 
+		MyThreadPool::GetInstance()->ParallelFor(8, [this, a_uNode, uFirst](uint a_uChild, uint a_uThread)
 		{
-			count++;
+			FillChild(a_uNode, uFirst + a_uChild);
+		});
+	}
+	else
+	{
+		for (uint j = 0; j < 8; j++)
+		{
+			FillChild(a_uNode, uFirst + j);
 		}
+	}
+	m_lNodeEntity[a_uNode].clear();
 
-		if (count > a_nEntities) 
+	for (uint j = 0; j < 8; j++)
+	{
+		Distribute(uFirst + j, a_pRange, a_pTaskList);
+	}
+}
+
+void MyOctant::FillChild(uint a_uNode, uint a_uChild)
+{
+	//hand the entities down to the child if they overlap it, a batch of boxes at a time
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	std::vector<uint>& lEntity = m_lNodeEntity[a_uNode];
+	std::vector<uint>& lChildEntity = m_lNodeEntity[a_uChild];
+	Node const& child = m_lNode[a_uChild];
+	uint uCount = lEntity.size();
+	for (uint i = 0; i < uCount; i += MyAABBStore::m_uBatch)
+	{
+		uint uMask = pStore->OverlapMask(child.m_v3Min, child.m_v3Max, &lEntity[i], uCount - i);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
 		{
-			return true;
+			if (uMask & 1)
+				lChildEntity.push_back(lEntity[i + k]);
 		}
+	}
+}
 
+void MyOctant::SplitLeaf(uint a_uNode)
+{
+	if (m_lNode[a_uNode].m_uChildren != 0 || m_lNode[a_uNode].m_uLevel >= m_uMaxLevel)
+	{
+		return;
 	}
-	return false;
+
+	//the entities will be tagged again with the leafs they end up in
+	std::vector<uint> const& lEntity = m_lNodeEntity[a_uNode];
+	for (uint i = 0; i < lEntity.size(); i++)
+	{
+		m_pEntityMngr->RemoveDimension(lEntity[i], a_uNode);
+	}
+	Distribute(a_uNode);
 }
 
-void MyOctant::KillBranches() 
+bool MyOctant::TryCollapse(uint a_uNode)
 {
-	//remove all child branches
-	for (int i = 0; i < m_uChildren; i++) 
+	if (m_lNode[a_uNode].m_uChildren == 0)
+	{
+		return false;
+	}
+
+	//the union of the children, an entity can live in more than one of them
+	uint uFirst = m_lNode[a_uNode].m_uFirstChild;
+	std::vector<uint> lEntity;
+	for (uint i = 0; i < 8; i++)
+	{
+		if (m_lNode[uFirst + i].m_uChildren != 0)
+		{
+			return false;
+		}
+		lEntity.insert(lEntity.end(), m_lNodeEntity[uFirst + i].begin(), m_lNodeEntity[uFirst + i].end());
+	}
+	std::sort(lEntity.begin(), lEntity.end());
+	lEntity.erase(std::unique(lEntity.begin(), lEntity.end()), lEntity.end());
+	if (lEntity.size() > m_uIdealEntityCount)
+	{
+		return false;
+	}
+
+	for (uint i = 0; i < 8; i++)
 	{
-		m_pChild[i]->KillBranches();
-		SafeDelete(m_pChild[i]);
+		std::vector<uint> const& lChildEntity = m_lNodeEntity[uFirst + i];
+		for (uint j = 0; j < lChildEntity.size(); j++)
+		{
+			m_pEntityMngr->RemoveDimension(lChildEntity[j], uFirst + i);
+		}
 	}
-	m_uChildren = 0;
+	KillBranches(a_uNode);
+
+	m_lNodeEntity[a_uNode] = lEntity;
+	for (uint i = 0; i < lEntity.size(); i++)
+	{
+		m_pEntityMngr->AddDimension(lEntity[i], a_uNode);
+	}
+	return true;
 }
 
-void MyOctant::ClearEntityList()
+void MyOctant::UpdateEntities(std::vector<uint> const& a_lEntity)
 {
-	for (int i = 0; i < m_uChildren; i++) 
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	std::vector<uint> lLeaf; //leafs the current entity overlaps now
+	std::vector<uint> lGrown; //leafs that received entities
+	std::vector<uint> lShrunk; //leafs that lost entities
+
+	//the root only grows when the tree is built again
+	vector3 v3RootMin = m_lNode[0].m_v3Min;
+	vector3 v3RootMax = m_lNode[0].m_v3Max;
+	for (uint i = 0; i < a_lEntity.size(); i++)
 	{
-		m_pChild[i]->ClearEntityList();
+		uint uIndex = a_lEntity[i];
+		if (uIndex >= nObjects)
+		{
+			continue;
+		}
+		vector3 v3Min = pStore->GetMin(uIndex);
+		vector3 v3Max = pStore->GetMax(uIndex);
+		if (v3Min.x < v3RootMin.x || v3Min.y < v3RootMin.y || v3Min.z < v3RootMin.z ||
+			v3Max.x > v3RootMax.x || v3Max.y > v3RootMax.y || v3Max.z > v3RootMax.z)
+		{
+			ConstructTree(m_uMaxLevel);
+			return;
+		}
+	}
+
+	for (uint i = 0; i < a_lEntity.size(); i++)
+	{
+		uint uIndex = a_lEntity[i];
+		if (uIndex >= nObjects)
+		{
+			continue;
+		}
+		MyEntity* pEntity = m_pEntityMngr->GetEntity(uIndex);
+
+		lLeaf.clear();
+		CollectLeafs(0, pStore->GetMin(uIndex), pStore->GetMax(uIndex), lLeaf);
+
+		//leave the leafs it no longer overlaps, backwards as the set shrinks while we look
+		for (uint d = pEntity->GetDimensionCount(); d > 0; d--)
+		{
+			uint uDimension = pEntity->GetDimension(d - 1);
+			bool bInTree = IsInTree(uDimension);
+			if (bInTree && std::find(lLeaf.begin(), lLeaf.end(), uDimension) != lLeaf.end())
+			{
+				continue;
+			}
+			if (bInTree)
+			{
+				std::vector<uint>& lList = m_lNodeEntity[uDimension];
+				std::vector<uint>::iterator it = std::find(lList.begin(), lList.end(), uIndex);
+				if (it != lList.end())
+				{
+					*it = lList.back();
+					lList.pop_back();
+				}
+				lShrunk.push_back(uDimension);
+			}
+			pEntity->RemoveDimension(uDimension);
+		}
+
+		//enter the leafs it overlaps now
+		for (uint j = 0; j < lLeaf.size(); j++)
+		{
+			if (pEntity->IsInDimension(lLeaf[j]))
+			{
+				continue;
+			}
+			m_lNodeEntity[lLeaf[j]].push_back(uIndex);
+			pEntity->AddDimension(lLeaf[j]);
+			lGrown.push_back(lLeaf[j]);
+		}
+	}
+
+	//subdivide the leafs that went over the ideal count
+	for (uint i = 0; i < lGrown.size(); i++)
+	{
+		if (m_lNode[lGrown[i]].m_uChildren == 0 && m_lNodeEntity[lGrown[i]].size() > m_uIdealEntityCount)
+		{
+			SplitLeaf(lGrown[i]);
+		}
+	}
+
+	//collapse the branches that went under it, a previous collapse might have released
+	//the leaf already
+	for (uint i = 0; i < lShrunk.size(); i++)
+	{
+		if (!IsInTree(lShrunk[i]))
+		{
+			continue;
+		}
+		uint uParent = m_lNode[lShrunk[i]].m_uParent;
+		while (uParent != static_cast<uint>(-1) && TryCollapse(uParent))
+		{
+			uParent = m_lNode[uParent].m_uParent;
+		}
+	}
+
+	if (lGrown.size() > 0 || lShrunk.size() > 0)
+	{
+		m_lLeaf.clear();
+		ConstructList(0);
 	}
-	m_lEntityList.clear();
 }
 
-void MyOctant::AssignIDtoEntity() 
+void MyOctant::RemoveEntity(uint a_uIndex)
 {
-	for (int i = 0; i < m_uChildren; i++) 
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (a_uIndex >= nObjects)
 	{
-		m_pChild[i]->AssignIDtoEntity();
+		return;
 	}
-	if (IsLeaf()) 
+
+	//take the entity out of its leafs
+	bool bShrunk = false;
+	MyEntity* pEntity = m_pEntityMngr->GetEntity(a_uIndex);
+	for (uint d = 0; d < pEntity->GetDimensionCount(); d++)
 	{
-		int nEntities = m_pEntityMngr->GetEntityCount();
-		for (int i = 0; i < nEntities; i++) 
+		uint uDimension = pEntity->GetDimension(d);
+		if (!IsInTree(uDimension))
 		{
-			if (IsColliding(i)) 
+			continue;
+		}
+		std::vector<uint>& lList = m_lNodeEntity[uDimension];
+		std::vector<uint>::iterator it = std::find(lList.begin(), lList.end(), a_uIndex);
+		if (it != lList.end())
+		{
+			*it = lList.back();
+			lList.pop_back();
+			bShrunk = true;
+		}
+	}
+
+	//the last entity takes its index, the leafs it is in are renamed to match
+	uint uLast = nObjects - 1;
+	if (a_uIndex != uLast)
+	{
+		MyEntity* pLast = m_pEntityMngr->GetEntity(uLast);
+		for (uint d = 0; d < pLast->GetDimensionCount(); d++)
+		{
+			uint uDimension = pLast->GetDimension(d);
+			if (!IsInTree(uDimension))
 			{
-				m_lEntityList.push_back(i);
-				m_pEntityMngr->AddDimension(i, m_uID);
+				continue;
 			}
+			std::vector<uint>& lList = m_lNodeEntity[uDimension];
+			std::replace(lList.begin(), lList.end(), uLast, a_uIndex);
 		}
 	}
+
+	//collapsing would retag entities whose index is about to change, the branches are
+	//left for the next update to collapse
+	if (bShrunk)
+	{
+		m_lLeaf.clear();
+		ConstructList(0);
+	}
+}
+
+uint MyOctant::QueryBox(vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity)
+{
+	uint uCount = 0;
+	if (BeginQuery())
+	{
+		CollectBox(0, a_v3Min, a_v3Max, a_pEntity, a_uCapacity, uCount);
+	}
+	else
+	{
+		ScanBox(a_v3Min, a_v3Max, a_pEntity, a_uCapacity, uCount);
+	}
+	return uCount;
+}
+
+uint MyOctant::QuerySphere(vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity)
+{
+	if (a_fRadius < 0.0f)
+	{
+		return 0;
+	}
+
+	uint uCount = 0;
+	if (BeginQuery())
+	{
+		CollectSphere(0, a_v3Center, a_fRadius, a_pEntity, a_uCapacity, uCount);
+	}
+	else
+	{
+		ScanSphere(a_v3Center, a_fRadius, a_pEntity, a_uCapacity, uCount);
+	}
+	return uCount;
+}
+
+uint MyOctant::QueryPoint(vector3 const& a_v3Point, uint* a_pEntity, uint a_uCapacity)
+{
+	//a point is a box with no volume
+	return QueryBox(a_v3Point, a_v3Point, a_pEntity, a_uCapacity);
+}
+
+bool MyOctant::BeginQuery()
+{
+	//the leafs are only kept in step with the entities while the manager follows this tree,
+	//otherwise they are good until a box changes
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	if (m_pEntityMngr->GetBroadPhase() == BP_OCTREE && m_pEntityMngr->GetOctree() == this)
+	{
+		m_pEntityMngr->RefreshOctree();
+		m_uStoreVersion = pStore->GetVersion();
+	}
+
+	//an entity can live in several leafs, the stamps keep it from being found twice
+	uint nObjects = m_pEntityMngr->GetEntityCount();
+	if (m_lQueryMark.size() < nObjects)
+	{
+		m_lQueryMark.resize(nObjects, 0);
+	}
+	++m_uQueryStamp;
+	if (m_uQueryStamp == 0)
+	{
+		std::fill(m_lQueryMark.begin(), m_lQueryMark.end(), 0);
+		m_uQueryStamp = 1;
+	}
+	return m_uStoreVersion == pStore->GetVersion();
 }
 
-void MyOctant::ConstructTree(uint a_nMaxLevel) 
+void MyOctant::AddQueryResult(uint a_uIndex, uint* a_pEntity, uint a_uCapacity, uint& a_uCount)
 {
-	if (m_uLevel != 0) 
+	uint& uMark = m_lQueryMark[a_uIndex];
+	if (uMark == m_uQueryStamp)
 	{
 		return;
 	}
-	m_uMaxLevel = a_nMaxLevel;
+	uMark = m_uQueryStamp;
+	if (a_uCount < a_uCapacity)
+	{
+		a_pEntity[a_uCount] = a_uIndex;
+	}
+	a_uCount++;
+}
+
+void MyOctant::CollectBox(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity, uint& a_uCount)
+{
+	if (!IsColliding(a_uNode, a_v3Min, a_v3Max))
+	{
+		return;
+	}
+	Node const& node = m_lNode[a_uNode];
+	if (node.m_uChildren != 0)
+	{
+		for (uint i = 0; i < node.m_uChildren; i++)
+		{
+			CollectBox(node.m_uFirstChild + i, a_v3Min, a_v3Max, a_pEntity, a_uCapacity, a_uCount);
+		}
+		return;
+	}
+
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	std::vector<uint>& lEntity = m_lNodeEntity[a_uNode];
+	uint uCount = lEntity.size();
+	for (uint i = 0; i < uCount; i += MyAABBStore::m_uBatch)
+	{
+		uint uMask = pStore->OverlapMask(a_v3Min, a_v3Max, &lEntity[i], uCount - i);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+		{
+			if (uMask & 1)
+			{
+				AddQueryResult(lEntity[i + k], a_pEntity, a_uCapacity, a_uCount);
+			}
+		}
+	}
+}
 
-	ClearEntityList();
-	KillBranches();
-	m_lChild.clear();
+void MyOctant::CollectSphere(uint a_uNode, vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity, uint& a_uCount)
+{
+	Node const& node = m_lNode[a_uNode];
+	float fRadiusSquared = a_fRadius * a_fRadius;
+	if (GetDistanceSquared(a_v3Center, node.m_v3Min, node.m_v3Max) > fRadiusSquared)
+	{
+		return;
+	}
+	if (node.m_uChildren != 0)
+	{
+		for (uint i = 0; i < node.m_uChildren; i++)
+		{
+			CollectSphere(node.m_uFirstChild + i, a_v3Center, a_fRadius, a_pEntity, a_uCapacity, a_uCount);
+		}
+		return;
+	}
 
-	Subdivide();
-	AssignIDtoEntity();
-	ConstructList();
+	//the box around the sphere rejects most entities a batch at a time
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	vector3 v3Min = a_v3Center - vector3(a_fRadius);
+	vector3 v3Max = a_v3Center + vector3(a_fRadius);
+	std::vector<uint>& lEntity = m_lNodeEntity[a_uNode];
+	uint uCount = lEntity.size();
+	for (uint i = 0; i < uCount; i += MyAABBStore::m_uBatch)
+	{
+		uint uMask = pStore->OverlapMask(v3Min, v3Max, &lEntity[i], uCount - i);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+		{
+			if ((uMask & 1) == 0)
+			{
+				continue;
+			}
+			uint uIndex = lEntity[i + k];
+			if (GetDistanceSquared(a_v3Center, pStore->GetMin(uIndex), pStore->GetMax(uIndex)) <= fRadiusSquared)
+			{
+				AddQueryResult(uIndex, a_pEntity, a_uCapacity, a_uCount);
+			}
+		}
+	}
 }
 
-void MyOctant::ConstructList()
+void MyOctant::ScanBox(vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity, uint& a_uCount)
 {
-	for (int i = 0; i < m_uChildren; i++) 
+	//every entity is tested once, the stamps are not needed
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	uint nObjects = pStore->GetCount();
+	for (uint i = 0; i < nObjects; i += MyAABBStore::m_uBatch)
 	{
-		m_pChild[i]->ConstructList();
+		uint uMask = pStore->OverlapMask(a_v3Min, a_v3Max, i, nObjects - i);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+		{
+			if (uMask & 1)
+			{
+				if (a_uCount < a_uCapacity)
+				{
+					a_pEntity[a_uCount] = i + k;
+				}
+				a_uCount++;
+			}
+		}
 	}
+}
 
-	if (m_lEntityList.size() > 0) 
+void MyOctant::ScanSphere(vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity, uint& a_uCount)
+{
+	//same box first as CollectSphere, the distance only for the boxes it keeps
+	MyAABBStore* pStore = m_pEntityMngr->GetAABBStore();
+	float fRadiusSquared = a_fRadius * a_fRadius;
+	vector3 v3Min = a_v3Center - vector3(a_fRadius);
+	vector3 v3Max = a_v3Center + vector3(a_fRadius);
+	uint nObjects = pStore->GetCount();
+	for (uint i = 0; i < nObjects; i += MyAABBStore::m_uBatch)
 	{
-		m_pRoot->m_lChild.push_back(this);
+		uint uMask = pStore->OverlapMask(v3Min, v3Max, i, nObjects - i);
+		for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+		{
+			if ((uMask & 1) && GetDistanceSquared(a_v3Center, pStore->GetMin(i + k), pStore->GetMax(i + k)) <= fRadiusSquared)
+			{
+				if (a_uCount < a_uCapacity)
+				{
+					a_pEntity[a_uCount] = i + k;
+				}
+				a_uCount++;
+			}
+		}
 	}
-}
\ No newline at end of file
+}
+
+float MyOctant::GetDistanceSquared(vector3 const& a_v3Point, vector3 const& a_v3Min, vector3 const& a_v3Max)
+{
+	vector3 v3Offset = glm::clamp(a_v3Point, a_v3Min, a_v3Max) - a_v3Point;
+	return glm::dot(v3Offset, v3Offset);
+}
@@ -7,33 +7,58 @@ using namespace Simplex;
 
 class MyOctant
 {
-	static uint m_uOctantCount; // The number of octants
-	static uint m_uMaxLevel; // Max number of octants
-	static uint m_uIdealEntityCount; // How many ideal entities the object will contain
-	uint m_uID = 0; // The current ID of this octant
-	uint m_uLevel = 0; // Current level of octant
-	uint m_uChildren = 0; // Number of child octants
+	// An octant of the tree, its ID is its index in the node pool and the 8 children of a
+	// node are stored next to each other
+	struct Node
+	{
+		vector3 m_v3Center = vector3(0.0f); // Center of the octant in global space
+		vector3 m_v3Min = vector3(0.0f); // Minimum of the octant in global space
+		vector3 m_v3Max = vector3(0.0f); // Maximum of the octant in global space
+		float m_fSize = 0.0f; // Size of each side of the octant
+		uint m_uLevel = 0; // Level of the octant
+		uint m_uParent = static_cast<uint>(-1); // Index of the parent in the node pool, -1 for the root
+		uint m_uFirstChild = 0; // Index of the first of the 8 children in the node pool
+		uint m_uChildren = 0; // Number of children (either 0 or 8)
+		bool m_bInUse = true; // Is this octant part of the tree (false once a collapse released it)
+	};
 
-	float m_fSize = 0.0f; // size
+	// Slots of the node pool a subtree built by a task allocates from, refilled in chunks
+	// from a counter shared by every task
+	struct BroodRange
+	{
+		uint m_uNext = 0; // First slot not handed out yet
+		uint m_uEnd = 0; // One past the last slot of the range
+		std::atomic<uint>* m_pPoolNext = nullptr; // First slot of the pool no task has taken yet
+		uint m_uPoolEnd = 0; // Slots the pool can hold
+	};
+
+	static bool m_bParallelBuild; // Are the subtrees under the task level built by the thread pool
+	static uint m_uTaskLevel; // Level whose octants become the tasks of a parallel build
+	static const uint m_uTaskChunk = 16; // Slots a task of a parallel build takes from the pool at once
+	static const uint m_uParallelLevelCap = 5; // Deepest tree built in parallel, deeper ones are built serially
+
+	uint m_uMaxLevel = 0; // Max level of subdivision
+	uint m_uIdealEntityCount = 5; // How many ideal entities an octant will contain
 
 	MeshManager* m_pMeshMngr = nullptr;
 	MyEntityManager* m_pEntityMngr = nullptr;
 
-	vector3 m_v3Min = vector3(0.0f);
-	vector3 m_v3Max = vector3(0.0f);
-	vector3 m_v3Center = vector3(0.0f);
+	std::vector<Node> m_lNode; // Node pool, the root first and then groups of 8 siblings
+	std::vector<std::vector<uint>> m_lNodeEntity; // Entities (index in the Entity Manager) of each node, only the leafs keep theirs
+	std::vector<uint> m_lFreeBrood; // Index of the first slot of each group of 8 released by a collapse
+	std::vector<uint> m_lLeaf; // Index of the leafs that contain entities
 
-	MyOctant* m_pParent = nullptr;
-	MyOctant* m_pChild[8];
-	std::vector<uint> m_lEntityList;
+	std::vector<uint> m_lTask; // Octants left to the tasks of a parallel build
+	std::vector<BroodRange> m_lTaskRange; // Slice of the pool of each task of a parallel build
 
-	MyOctant* m_pRoot = nullptr;
-	std::vector<MyOctant*> m_lChild;
+	std::vector<uint> m_lQueryMark; // Stamp of the last query that found each entity
+	uint m_uQueryStamp = 0; // Stamp of the query in progress
+	uint m_uStoreVersion = 0; // Version of the AABB store the leafs were last known to match
 
 public:
 	/*
-	USAGE: Constructor, will create an octant containing all MagnaEntities Instances in the Mesh
-	manager	currently contains
+	USAGE: Constructor, will create an octree containing all the entities the Entity Manager
+	currently contains
 	ARGUMENTS:
 	- uint a_nMaxLevel = 2 -> Sets the maximum level of subdivision
 	- uint nIdealEntityCount = 5 -> Sets the ideal level of objects per octant
@@ -41,14 +66,6 @@ public:
 	*/
 	MyOctant(uint a_nMaxLevel = 2, uint a_nIdealEntityCount = 5);
 	/*
-	USAGE: Constructor
-	ARGUMENTS:
-	- vector3 a_v3Center -> Center of the octant in global space
-	- float a_fSize -> size of each side of the octant volume
-	OUTPUT: class object
-	*/
-	MyOctant(vector3 a_v3Center, float a_fSize);
-	/*
 	USAGE: Copy Constructor
 	ARGUMENTS: class object to copy
 	OUTPUT: class object instance
@@ -74,39 +91,31 @@ public:
 	*/
 	void Swap(MyOctant& other);
 	/*
-	USAGE: Gets this octant's size
+	USAGE: Gets the size of the root
 	ARGUMENTS: ---
-	OUTPUT: size of octant
+	OUTPUT: size of the root
 	*/
 	float GetSize(void);
 	/*
-	USAGE: Gets the center of the octant in global scape
+	USAGE: Gets the center of the root in global scape
 	ARGUMENTS: ---
-	OUTPUT: Center of the octant in global space
+	OUTPUT: Center of the root in global space
 	*/
 	vector3 GetCenterGlobal(void);
 	/*
-	USAGE: Gets the min corner of the octant in global space
+	USAGE: Gets the min corner of the root in global space
 	ARGUMENTS: ---
 	OUTPUT: Minimum in global space
 	*/
 	vector3 GetMinGlobal(void);
 	/*
-	USAGE: Gets the max corner of the octant in global space
+	USAGE: Gets the max corner of the root in global space
 	ARGUMENTS: ---
 	OUTPUT: Maximum in global space
 	*/
 	vector3 GetMaxGlobal(void);
 	/*
-	USAGE: Asks if there is a collision with the Entity specified by index from
-	the Bounding Object Manager
-	ARGUMENTS:
-	- int a_uRBIndex -> Index of the Entity in the Entity Manager
-	OUTPUT: check of the collision
-	*/
-	bool IsColliding(uint a_uRBIndex);
-	/*
-	USAGE: Displays the Octant volume specified by index including the objects underneath
+	USAGE: Displays the Octant volume specified by ID
 	ARGUMENTS:
 	- uint a_nIndex -> Octant to be displayed.
 	- vector3 a_v3Color = REYELLOW -> Color of the volume to display.
@@ -114,7 +123,7 @@ public:
 	*/
 	void Display(uint a_nIndex, vector3 a_v3Color = C_YELLOW);
 	/*
-	USAGE: Displays the Octant volume in the color specified
+	USAGE: Displays every octant of the tree in the color specified
 	ARGUMENTS:
 	- vector3 a_v3Color = REYELLOW -> Color of the volume to display.
 	OUTPUT: ---
@@ -128,68 +137,140 @@ public:
 	*/
 	void DisplayLeafs(vector3 a_v3Color = C_YELLOW);
 	/*
-	USAGE: Clears the Entity list for each node
-	ARGUMENTS: ---
+	USAGE: Rebuilds the tree from the current position of the entities: fits the root
+	around them and hands their list down the tree. The node pool is reset in one go and
+	keeps its memory, so changing the level does not need a new octree
+	ARGUMENTS:
+	- uint a_nMaxLevel = 3 -> Sets the maximum level of the tree while constructing it
 	OUTPUT: ---
 	*/
-	void ClearEntityList(void);
+	void ConstructTree(uint a_nMaxLevel = 3);
 	/*
-	USAGE: allocates 8 smaller octants in the child pointers
+	USAGE: Gets the max level of subdivision of the tree
 	ARGUMENTS: ---
-	OUTPUT: ---
+	OUTPUT: max level
 	*/
-	void Subdivide(void);
+	uint GetMaxLevel(void);
 	/*
-	USAGE: returns the child specified in the index
-	ARGUMENTS: uint a_nChild -> index of the child (from 0 to 7)
-	OUTPUT: Octant object (child in index)
+	USAGE: Gets the total number of octants in the tree, including the slots released by
+	a collapse that are waiting to be reused
+	ARGUMENTS: ---
+	OUTPUT: octant count
 	*/
-	MyOctant* GetChild(uint a_nChild);
+	uint GetOctantCount(void);
 	/*
-	USAGE: returns the parent of the octant
+	USAGE: Gets the number of leafs that contain entities
 	ARGUMENTS: ---
-	OUTPUT: Octant object (parent)
+	OUTPUT: number of non empty leafs
 	*/
-	MyOctant* GetParent(void);
+	uint GetLeafCount(void);
 	/*
-	USAGE: Asks the Octant if it does not contain any children (its a leaf)
-	ARGUMENTS: ---
-	OUTPUT: It contains no children
+	USAGE: Gets the ID of the non empty leaf specified by index, this is the dimension its
+	entities are tagged with
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: ID of the leaf, -1 if out of bounds
+	*/
+	uint GetLeafID(uint a_uIndex);
+	/*
+	USAGE: Gets the number of entities in the non empty leaf specified by index
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: entity count
+	*/
+	uint GetLeafEntityCount(uint a_uIndex);
+	/*
+	USAGE: Gets the entities (index in the Entity Manager) overlapping the non empty leaf
+	specified by index
+	ARGUMENTS: uint a_uIndex -> index in the list of non empty leafs
+	OUTPUT: pointer to the first of GetLeafEntityCount entries, nullptr if out of bounds
 	*/
-	bool IsLeaf(void);
+	uint const* GetLeafEntityList(uint a_uIndex);
+
 	/*
-	USAGE: Asks the Octant if it contains more than this many Bounding Objects
+	USAGE: Relocates the entities whose global bounding box changed, moving them only
+	between the leafs they left and the leafs they entered. Leafs that go over the ideal
+	entity count are subdivided and branches that fall under it are collapsed
 	ARGUMENTS:
-	- uint a_nEntities -> Number of Entities to query
-	OUTPUT: It contains at least this many Entities
+	- std::vector<uint> const& a_lEntity -> Index in the Entity Manager of the moved (or
+	added) entities, the tree is rebuilt if one of them left the root
+	OUTPUT: ---
 	*/
-	bool CheckObjectCount(uint a_nEntities);
+	void UpdateEntities(std::vector<uint> const& a_lEntity);
+
 	/*
-	USAGE: Deletes all children and the children of their children (almost sounds apocalyptic)
-	ARGUMENTS: ---
+	USAGE: Follows the removal of an entity from the Entity Manager, which moves the last
+	entity into its index. Has to be called before the removal, while both entities still
+	carry the dimensions of their leafs
+	ARGUMENTS:
+	- uint a_uIndex -> Index in the Entity Manager of the entity being removed
 	OUTPUT: ---
 	*/
-	void KillBranches(void);
+	void RemoveEntity(uint a_uIndex);
+
 	/*
-	USAGE: Creates a tree using subdivisions, the max number of objects and levels
+	USAGE: Finds the entities whose box overlaps the box, descending only through the octants
+	the box overlaps. The boxes are the swept ones of the AABB store, so a continuous rigid
+	body is found anywhere along its last step. The leafs only follow the entities while this
+	octree is the broad phase in use, the pending moves are applied first. Otherwise they are
+	only used if no box changed since the tree was built, every box of the store is tested if
+	one did, so the same entities are found in any broad phase
 	ARGUMENTS:
-	- uint a_nMaxLevel = 3 -> Sets the maximum level of the tree while constructing it
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- uint* a_pEntity -> buffer the entities (index in the Entity Manager) are written to
+	- uint a_uCapacity -> entities the buffer can hold
+	OUTPUT: number of entities found, if larger than the capacity only the first ones were written
+	*/
+	uint QueryBox(vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity);
+
+	/*
+	USAGE: Finds the entities whose swept box is touched by the sphere, descending only
+	through the octants the sphere touches. Same conditions as QueryBox
+	ARGUMENTS:
+	- vector3 const& a_v3Center -> center of the sphere in global space
+	- float a_fRadius -> radius of the sphere
+	- uint* a_pEntity -> buffer the entities (index in the Entity Manager) are written to
+	- uint a_uCapacity -> entities the buffer can hold
+	OUTPUT: number of entities found, if larger than the capacity only the first ones were written
+	*/
+	uint QuerySphere(vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity);
+
+	/*
+	USAGE: Finds the entities whose swept box contains the point, descending only through
+	the octants that contain it. Same conditions as QueryBox
+	ARGUMENTS:
+	- vector3 const& a_v3Point -> point in global space
+	- uint* a_pEntity -> buffer the entities (index in the Entity Manager) are written to
+	- uint a_uCapacity -> entities the buffer can hold
+	OUTPUT: number of entities found, if larger than the capacity only the first ones were written
+	*/
+	uint QueryPoint(vector3 const& a_v3Point, uint* a_pEntity, uint a_uCapacity);
+
+	/*
+	USAGE: Sets whether the trees are built in parallel, the octants of the task level that
+	still need to be split are handed to the thread pool, each one allocating from its own
+	slice of the node pool, while the levels above fill their children in parallel; trees
+	deeper than the level cap are always built serially
+	ARGUMENTS:
+	- bool a_bParallel -> build in parallel?
+	- uint a_uTaskLevel = 2 -> level whose octants become tasks (at least 1)
 	OUTPUT: ---
 	*/
-	void ConstructTree(uint a_nMaxLevel = 3);
+	static void SetParallelBuild(bool a_bParallel, uint a_uTaskLevel = 2);
+
 	/*
-	USAGE: Traverse the tree up to the leafs and sets the objects in them to the index
+	USAGE: Tells whether the trees are built in parallel
 	ARGUMENTS: ---
-	OUTPUT: ---
+	OUTPUT: are they built in parallel?
 	*/
-	void AssignIDtoEntity(void);
+	static bool GetParallelBuild(void);
 
 	/*
-	USAGE: Gets the total number of octants in the world
+	USAGE: Builds the tree again serially and in parallel and compares both, then leaves it
+	built the way SetParallelBuild asks for; the entities end up tagged with this tree
 	ARGUMENTS: ---
-	OUTPUT: ---
+	OUTPUT: do both builds give the same leafs, in the same order and with the same entities?
 	*/
-	uint GetOctantCount(void);
+	bool CheckParallelBuild(void);
 
 private:
 	/*
@@ -205,12 +286,188 @@ private:
 	*/
 	void Init(void);
 	/*
-	USAGE: creates the list of all leafs that contains objects.
+	USAGE: Fits the root cube around the global bounding box of every entity
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void ComputeBounds(void);
+	/*
+	USAGE: Asks if the octant specified by ID overlaps the box specified in global space
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	OUTPUT: check of the collision
+	*/
+	bool IsColliding(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max);
+	/*
+	USAGE: creates the list of all leafs under the octant that contain objects.
+	ARGUMENTS: uint a_uNode -> ID of the octant
+	OUTPUT: ---
+	*/
+	void ConstructList(uint a_uNode);
+	/*
+	USAGE: allocates the 8 children of the octant without filling them, if the pool of a
+	parallel build is exhausted the octant stays a leaf
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- BroodRange* a_pRange = nullptr -> slice of the pool to take them from, the free
+	slots or the end of the pool if none
+	OUTPUT: ---
+	*/
+	void CreateChildren(uint a_uNode, BroodRange* a_pRange = nullptr);
+	/*
+	USAGE: hands out 8 contiguous slots of the node pool, reusing released ones first
+	ARGUMENTS: ---
+	OUTPUT: index of the first slot
+	*/
+	uint AllocateBrood(void);
+	/*
+	USAGE: Asks if the octant with the specified ID is part of the tree
+	ARGUMENTS: uint a_uID -> ID of the octant
+	OUTPUT: is it in use?
+	*/
+	bool IsInTree(uint a_uID);
+	/*
+	USAGE: releases the children of the octant and the children of their children, their
+	slots go back to the pool
+	ARGUMENTS: uint a_uNode -> ID of the octant
+	OUTPUT: ---
+	*/
+	void KillBranches(uint a_uNode);
+	/*
+	USAGE: collects the leafs under the octant the box overlaps
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- std::vector<uint>& a_lLeaf -> list to append the leafs to
+	OUTPUT: ---
+	*/
+	void CollectLeafs(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, std::vector<uint>& a_lLeaf);
+	/*
+	USAGE: hands the entity list of the octant down to newly allocated children, each
+	entity is only tested against the children of the octants it already overlaps;
+	recurses until the lists fit the ideal count or the max level is reached and tags
+	the entities with the ID of the leafs they end up in
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- BroodRange* a_pRange = nullptr -> if given the children come from this slice of the
+	pool and the leafs are not tagged, so a task can build the subtree on its own
+	- std::vector<uint>* a_pTaskList = nullptr -> if given the octants of the task level
+	that need to be split are appended to it instead, and the children are filled in parallel
+	OUTPUT: ---
+	*/
+	void Distribute(uint a_uNode, BroodRange* a_pRange = nullptr, std::vector<uint>* a_pTaskList = nullptr);
+	/*
+	USAGE: appends the entities of the octant that overlap the child to its entity list
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- uint a_uChild -> ID of the child
+	OUTPUT: ---
+	*/
+	void FillChild(uint a_uNode, uint a_uChild);
+	/*
+	USAGE: splits the levels above the task level, then builds the subtree of every octant
+	left at the task level as a task of the thread pool and tags the leafs
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void DistributeParallel(void);
+	/*
+	USAGE: tags the entities of every leaf under the octant with the ID of the leaf
+	ARGUMENTS: uint a_uNode -> ID of the octant
+	OUTPUT: ---
+	*/
+	void TagLeafs(uint a_uNode);
+	/*
+	USAGE: subdivides a leaf handing its entities down to the new children, recurses into
+	the children that are still over the ideal count
+	ARGUMENTS: uint a_uNode -> ID of the leaf
+	OUTPUT: ---
+	*/
+	void SplitLeaf(uint a_uNode);
+	/*
+	USAGE: turns the octant back into a leaf if all of its children are leafs and
+	together they hold no more than the ideal count of entities
+	ARGUMENTS: uint a_uNode -> ID of the octant
+	OUTPUT: was it collapsed?
+	*/
+	bool TryCollapse(uint a_uNode);
+	/*
+	USAGE: starts a new query, so the entities found by the previous ones can be found again.
+	Brings the leafs up to date with the entities first if the manager follows this tree
 	ARGUMENTS: ---
+	OUTPUT: do the leafs match the entities? if not the query has to test the store instead
+	*/
+	bool BeginQuery(void);
+	/*
+	USAGE: writes the entity to the buffer of the query unless the query already found it in another leaf
+	ARGUMENTS:
+	- uint a_uIndex -> Index of the Entity in the Entity Manager
+	- uint* a_pEntity -> buffer of the query
+	- uint a_uCapacity -> entities the buffer can hold
+	- uint& a_uCount -> entities found so far by the query
 	OUTPUT: ---
 	*/
-	void ConstructList(void);
+	void AddQueryResult(uint a_uIndex, uint* a_pEntity, uint a_uCapacity, uint& a_uCount);
+	/*
+	USAGE: collects the entities of the leafs under the octant whose box overlaps the box
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- uint* a_pEntity -> buffer of the query
+	- uint a_uCapacity -> entities the buffer can hold
+	- uint& a_uCount -> entities found so far by the query
+	OUTPUT: ---
+	*/
+	void CollectBox(uint a_uNode, vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity, uint& a_uCount);
+	/*
+	USAGE: collects the entities of the leafs under the octant whose box the sphere touches
+	ARGUMENTS:
+	- uint a_uNode -> ID of the octant
+	- vector3 const& a_v3Center -> center of the sphere in global space
+	- float a_fRadius -> radius of the sphere
+	- uint* a_pEntity -> buffer of the query
+	- uint a_uCapacity -> entities the buffer can hold
+	- uint& a_uCount -> entities found so far by the query
+	OUTPUT: ---
+	*/
+	void CollectSphere(uint a_uNode, vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity, uint& a_uCount);
+	/*
+	USAGE: collects every entity of the AABB store whose box overlaps the box, for the
+	queries the leafs cannot answer
+	ARGUMENTS:
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	- uint* a_pEntity -> buffer of the query
+	- uint a_uCapacity -> entities the buffer can hold
+	- uint& a_uCount -> entities found so far by the query
+	OUTPUT: ---
+	*/
+	void ScanBox(vector3 const& a_v3Min, vector3 const& a_v3Max, uint* a_pEntity, uint a_uCapacity, uint& a_uCount);
+	/*
+	USAGE: collects every entity of the AABB store whose box the sphere touches, for the
+	queries the leafs cannot answer
+	ARGUMENTS:
+	- vector3 const& a_v3Center -> center of the sphere in global space
+	- float a_fRadius -> radius of the sphere
+	- uint* a_pEntity -> buffer of the query
+	- uint a_uCapacity -> entities the buffer can hold
+	- uint& a_uCount -> entities found so far by the query
+	OUTPUT: ---
+	*/
+	void ScanSphere(vector3 const& a_v3Center, float a_fRadius, uint* a_pEntity, uint a_uCapacity, uint& a_uCount);
+	/*
+	USAGE: Gets the squared distance from a point to a box, 0 if the point is inside
+	ARGUMENTS:
+	- vector3 const& a_v3Point -> point in global space
+	- vector3 const& a_v3Min -> minimum of the box in global space
+	- vector3 const& a_v3Max -> maximum of the box in global space
+	OUTPUT: squared distance
+	*/
+	static float GetDistanceSquared(vector3 const& a_v3Point, vector3 const& a_v3Min, vector3 const& a_v3Max);
 };
 
 #endif
-
@@ -1,5 +1,9 @@
 #include "MyRigidBody.h"
+#include <immintrin.h>
+#include <functional>
 using namespace Simplex;
+std::atomic<uint> MyRigidBody::m_uTierCount[CT_COUNT];
+uint MyRigidBody::m_uVersionClock = 0;
 //Allocation
 void MyRigidBody::Init(void)
 {
@@ -9,6 +13,7 @@ void MyRigidBody::Init(void)
 	m_bVisibleARBB = false;
 
 	m_fRadius = 0.0f;
+	m_fRadiusG = 0.0f;
 
 	m_v3ColorColliding = C_RED;
 	m_v3ColorNotColliding = C_WHITE;
@@ -21,13 +26,23 @@ void MyRigidBody::Init(void)
 	m_v3MinG = ZERO_V3;
 	m_v3MaxG = ZERO_V3;
 
+	m_bContinuous = false;
+	m_v3MinGPrev = ZERO_V3;
+	m_v3MaxGPrev = ZERO_V3;
+
 	m_v3HalfWidth = ZERO_V3;
 	m_v3ARBBSize = ZERO_V3;
 
+	m_v3AxisG[0] = AXIS_X;
+	m_v3AxisG[1] = AXIS_Y;
+	m_v3AxisG[2] = AXIS_Z;
+	m_v3HalfWidthG = ZERO_V3;
+
 	m_m4ToWorld = IDENTITY_M4;
+	m_uVersion = ++m_uVersionClock;
 
-	m_nCollidingCount = 0;
-	m_CollidingArray = nullptr;
+	m_CollidingArray.clear();
+	m_SeparatingArray.clear();
 }
 void MyRigidBody::Swap(MyRigidBody& other)
 {
@@ -37,6 +52,7 @@ void MyRigidBody::Swap(MyRigidBody& other)
 	std::swap(m_bVisibleARBB, other.m_bVisibleARBB);
 
 	std::swap(m_fRadius, other.m_fRadius);
+	std::swap(m_fRadiusG, other.m_fRadiusG);
 
 	std::swap(m_v3ColorColliding, other.m_v3ColorColliding);
 	std::swap(m_v3ColorNotColliding, other.m_v3ColorNotColliding);
@@ -49,18 +65,33 @@ void MyRigidBody::Swap(MyRigidBody& other)
 	std::swap(m_v3MinG, other.m_v3MinG);
 	std::swap(m_v3MaxG, other.m_v3MaxG);
 
+	std::swap(m_bContinuous, other.m_bContinuous);
+	std::swap(m_v3MinGPrev, other.m_v3MinGPrev);
+	std::swap(m_v3MaxGPrev, other.m_v3MaxGPrev);
+
 	std::swap(m_v3HalfWidth, other.m_v3HalfWidth);
 	std::swap(m_v3ARBBSize, other.m_v3ARBBSize);
 
+	for (uint i = 0; i < 3; ++i)
+		std::swap(m_v3AxisG[i], other.m_v3AxisG[i]);
+	std::swap(m_v3HalfWidthG, other.m_v3HalfWidthG);
+
 	std::swap(m_m4ToWorld, other.m_m4ToWorld);
+	std::swap(m_uVersion, other.m_uVersion);
 
-	std::swap(m_nCollidingCount, other.m_nCollidingCount);
 	std::swap(m_CollidingArray, other.m_CollidingArray);
+	std::swap(m_SeparatingArray, other.m_SeparatingArray);
 }
 void MyRigidBody::Release(void)
 {
 	m_pMeshMngr = nullptr;
-	ClearCollidingList();
+	std::vector<PRigidBody>().swap(m_CollidingArray);
+	//the other bodies must not keep an axis for a pair that is gone
+	for (uint i = 0; i < m_SeparatingArray.size(); ++i)
+	{
+		m_SeparatingArray[i].m_pOther->ForgetSeparatingAxis(this);
+	}
+	std::vector<SeparatingAxis>().swap(m_SeparatingArray);
 }
 //Accessors
 bool MyRigidBody::GetVisibleBS(void) { return m_bVisibleBS; }
@@ -82,55 +113,122 @@ vector3 MyRigidBody::GetMinGlobal(void) { return m_v3MinG; }
 vector3 MyRigidBody::GetMaxGlobal(void) { return m_v3MaxG; }
 vector3 MyRigidBody::GetHalfWidth(void) { return m_v3HalfWidth; }
 matrix4 MyRigidBody::GetModelMatrix(void) { return m_m4ToWorld; }
+uint MyRigidBody::GetVersion(void) { return m_uVersion; }
+bool MyRigidBody::IsContinuous(void) { return m_bContinuous; }
+void MyRigidBody::SetContinuous(bool a_bContinuous)
+{
+	m_bContinuous = a_bContinuous;
+	m_v3MinGPrev = m_v3MinG;
+	m_v3MaxGPrev = m_v3MaxG;
+	//the swept box might have shrunk
+	m_uVersion = ++m_uVersionClock;
+}
+bool MyRigidBody::BeginStep(void)
+{
+	if (m_v3MinGPrev == m_v3MinG && m_v3MaxGPrev == m_v3MaxG)
+		return false;
+
+	//the box the body has now is where the sweep of its next move starts
+	m_v3MinGPrev = m_v3MinG;
+	m_v3MaxGPrev = m_v3MaxG;
+	if (!m_bContinuous)
+		return false;
+
+	//the box it swept collapses to where it is, the pairs it met on the way need a new test
+	m_uVersion = ++m_uVersionClock;
+	return true;
+}
+vector3 MyRigidBody::GetMinSwept(void) { return m_bContinuous ? glm::min(m_v3MinGPrev, m_v3MinG) : m_v3MinG; }
+vector3 MyRigidBody::GetMaxSwept(void) { return m_bContinuous ? glm::max(m_v3MaxGPrev, m_v3MaxG) : m_v3MaxG; }
 void MyRigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
 {
 	//to save some calculations if the model matrix is the same there is nothing to do here
 	if (a_m4ModelMatrix == m_m4ToWorld)
 		return;
 
-	//Assign the model matrix
+	//Assign the model matrix, the sweep still starts where the body was at BeginStep
 	m_m4ToWorld = a_m4ModelMatrix;
+	m_uVersion = ++m_uVersionClock;
 
-	m_v3CenterG = vector3(m_m4ToWorld * vector4(m_v3CenterL, 1.0f));
-
-	//Calculate the 8 corners of the cube
-	vector3 v3Corner[8];
-	//Back square
-	v3Corner[0] = m_v3MinL;
-	v3Corner[1] = vector3(m_v3MaxL.x, m_v3MinL.y, m_v3MinL.z);
-	v3Corner[2] = vector3(m_v3MinL.x, m_v3MaxL.y, m_v3MinL.z);
-	v3Corner[3] = vector3(m_v3MaxL.x, m_v3MaxL.y, m_v3MinL.z);
+	//the global box follows from the center and half widths, no need to visit the 8 corners
+	ComputeGlobalBox(m_m4ToWorld, m_v3CenterL, m_v3HalfWidth, m_v3MinG, m_v3MaxG);
+	m_v3CenterG = (m_v3MinG + m_v3MaxG) * 0.5f;
 
-	//Front square
-	v3Corner[4] = vector3(m_v3MinL.x, m_v3MinL.y, m_v3MaxL.z);
-	v3Corner[5] = vector3(m_v3MaxL.x, m_v3MinL.y, m_v3MaxL.z);
-	v3Corner[6] = vector3(m_v3MinL.x, m_v3MaxL.y, m_v3MaxL.z);
-	v3Corner[7] = m_v3MaxL;
+	//we calculate the distance between min and max vectors
+	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
 
-	//Place them in world space
-	for (uint uIndex = 0; uIndex < 8; ++uIndex)
+	UpdateOrientedBox();
+}
+void MyRigidBody::UpdateOrientedBox(void)
+{
+	//the columns of the matrix are the local axes scaled
+	float fScale = 0.0f;
+	for (uint i = 0; i < 3; ++i)
 	{
-		v3Corner[uIndex] = vector3(m_m4ToWorld * vector4(v3Corner[uIndex], 1.0f));
+		vector3 v3Column = vector3(m_m4ToWorld[i]);
+		float fLength = glm::length(v3Column);
+		//a flattened axis keeps the one of the identity so the test still has a frame
+		m_v3AxisG[i] = fLength > 0.0f ? v3Column / fLength : vector3(IDENTITY_M4[i]);
+		m_v3HalfWidthG[i] = m_v3HalfWidth[i] * fLength;
+		fScale = std::max(fScale, fLength);
 	}
+	//the sphere grows with the largest scale of the matrix
+	m_fRadiusG = m_fRadius * fScale;
+}
+void MyRigidBody::ComputeGlobalBox(matrix4 const& a_m4ToWorld, vector3 const& a_v3CenterL, vector3 const& a_v3HalfWidth,
+	vector3& a_v3MinG, vector3& a_v3MaxG)
+{
+	//the center is transformed as a point
+	vector3 v3Center = vector3(a_m4ToWorld * vector4(a_v3CenterL, 1.0f));
 
-	//Identify the max and min as the first corner
-	m_v3MaxG = m_v3MinG = v3Corner[0];
+	//each local axis adds its half width along the global axes in proportion to
+	//how much it points to them, the columns of the matrix are the local axes
+	vector3 v3Extent = glm::abs(vector3(a_m4ToWorld[0])) * a_v3HalfWidth.x +
+		glm::abs(vector3(a_m4ToWorld[1])) * a_v3HalfWidth.y +
+		glm::abs(vector3(a_m4ToWorld[2])) * a_v3HalfWidth.z;
 
-	//get the new max and min for the global box
-	for (uint i = 1; i < 8; ++i)
+	a_v3MinG = v3Center - v3Extent;
+	a_v3MaxG = v3Center + v3Extent;
+}
+void MyRigidBody::SetModelMatrixBatch(MyRigidBody* const* a_pRigidBody, matrix4 const* a_pModelMatrix, uint a_uCount)
+{
+	//clears the sign bit
+	const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	for (uint i = 0; i < a_uCount; ++i)
 	{
-		if (m_v3MaxG.x < v3Corner[i].x) m_v3MaxG.x = v3Corner[i].x;
-		else if (m_v3MinG.x > v3Corner[i].x) m_v3MinG.x = v3Corner[i].x;
-
-		if (m_v3MaxG.y < v3Corner[i].y) m_v3MaxG.y = v3Corner[i].y;
-		else if (m_v3MinG.y > v3Corner[i].y) m_v3MinG.y = v3Corner[i].y;
-
-		if (m_v3MaxG.z < v3Corner[i].z) m_v3MaxG.z = v3Corner[i].z;
-		else if (m_v3MinG.z > v3Corner[i].z) m_v3MinG.z = v3Corner[i].z;
+		MyRigidBody* pRigidBody = a_pRigidBody[i];
+		matrix4 const& m4ToWorld = a_pModelMatrix[i];
+		pRigidBody->m_m4ToWorld = m4ToWorld;
+		pRigidBody->m_uVersion = ++m_uVersionClock;
+
+		__m128 vColumn0 = _mm_loadu_ps(&m4ToWorld[0][0]);
+		__m128 vColumn1 = _mm_loadu_ps(&m4ToWorld[1][0]);
+		__m128 vColumn2 = _mm_loadu_ps(&m4ToWorld[2][0]);
+		__m128 vColumn3 = _mm_loadu_ps(&m4ToWorld[3][0]);
+
+		vector3 const& v3CenterL = pRigidBody->m_v3CenterL;
+		vector3 const& v3HalfWidth = pRigidBody->m_v3HalfWidth;
+
+		//same math as ComputeGlobalBox, the w lane is ignored
+		__m128 vCenter = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(vColumn0, _mm_set1_ps(v3CenterL.x)), _mm_mul_ps(vColumn1, _mm_set1_ps(v3CenterL.y))),
+			_mm_add_ps(_mm_mul_ps(vColumn2, _mm_set1_ps(v3CenterL.z)), vColumn3));
+		__m128 vExtent = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_and_ps(vColumn0, vAbsMask), _mm_set1_ps(v3HalfWidth.x)),
+				_mm_mul_ps(_mm_and_ps(vColumn1, vAbsMask), _mm_set1_ps(v3HalfWidth.y))),
+			_mm_mul_ps(_mm_and_ps(vColumn2, vAbsMask), _mm_set1_ps(v3HalfWidth.z)));
+
+		float fMin[4];
+		float fMax[4];
+		_mm_storeu_ps(fMin, _mm_sub_ps(vCenter, vExtent));
+		_mm_storeu_ps(fMax, _mm_add_ps(vCenter, vExtent));
+
+		pRigidBody->m_v3MinG = vector3(fMin[0], fMin[1], fMin[2]);
+		pRigidBody->m_v3MaxG = vector3(fMax[0], fMax[1], fMax[2]);
+		pRigidBody->m_v3CenterG = (pRigidBody->m_v3MinG + pRigidBody->m_v3MaxG) * 0.5f;
+		pRigidBody->m_v3ARBBSize = pRigidBody->m_v3MaxG - pRigidBody->m_v3MinG;
+		pRigidBody->UpdateOrientedBox();
 	}
-
-	//we calculate the distance between min and max vectors
-	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
 }
 //The big 3
 MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
@@ -162,6 +260,8 @@ MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
 	//with model matrix being the identity, local and global are the same
 	m_v3MinG = m_v3MinL;
 	m_v3MaxG = m_v3MaxL;
+	m_v3MinGPrev = m_v3MinG;
+	m_v3MaxGPrev = m_v3MaxG;
 
 	//with the max and the min we calculate the center
 	m_v3CenterL = (m_v3MaxL + m_v3MinL) / 2.0f;
@@ -171,6 +271,12 @@ MyRigidBody::MyRigidBody(std::vector<vector3> a_pointList)
 
 	//Get the distance between the center and either the min or the max
 	m_fRadius = glm::distance(m_v3CenterL, m_v3MinL);
+
+	//with model matrix being the identity, the global sphere is the local one
+	m_v3CenterG = m_v3CenterL;
+	m_fRadiusG = m_fRadius;
+	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
+	m_v3HalfWidthG = m_v3HalfWidth;
 }
 MyRigidBody::MyRigidBody(MyRigidBody const& other)
 {
@@ -181,6 +287,7 @@ MyRigidBody::MyRigidBody(MyRigidBody const& other)
 	m_bVisibleARBB = other.m_bVisibleARBB;
 
 	m_fRadius = other.m_fRadius;
+	m_fRadiusG = other.m_fRadiusG;
 
 	m_v3ColorColliding = other.m_v3ColorColliding;
 	m_v3ColorNotColliding = other.m_v3ColorNotColliding;
@@ -193,13 +300,22 @@ MyRigidBody::MyRigidBody(MyRigidBody const& other)
 	m_v3MinG = other.m_v3MinG;
 	m_v3MaxG = other.m_v3MaxG;
 
+	m_bContinuous = other.m_bContinuous;
+	m_v3MinGPrev = other.m_v3MinGPrev;
+	m_v3MaxGPrev = other.m_v3MaxGPrev;
+
 	m_v3HalfWidth = other.m_v3HalfWidth;
 	m_v3ARBBSize = other.m_v3ARBBSize;
 
+	for (uint i = 0; i < 3; ++i)
+		m_v3AxisG[i] = other.m_v3AxisG[i];
+	m_v3HalfWidthG = other.m_v3HalfWidthG;
+
 	m_m4ToWorld = other.m_m4ToWorld;
+	m_uVersion = ++m_uVersionClock;
 
-	m_nCollidingCount = other.m_nCollidingCount;
 	m_CollidingArray = other.m_CollidingArray;
+	//the separating axes belong to the pairs of the other body, the copy starts without them
 }
 MyRigidBody& MyRigidBody::operator=(MyRigidBody const& other)
 {
@@ -224,134 +340,414 @@ void MyRigidBody::AddCollisionWith(MyRigidBody* other)
 		the object is already there return with no changes
 	*/
 
-	//insert the entry
-	PRigidBody* pTemp;
-	pTemp = new PRigidBody[m_nCollidingCount + 1];
-	if (m_CollidingArray)
+	//insert the entry, only allocates when the set outgrows every previous frame
+	m_CollidingArray.push_back(other);
+}
+void MyRigidBody::RemoveCollisionWith(MyRigidBody* other)
+{
+	//we look one by one if its the one wanted
+	for (uint i = 0; i < m_CollidingArray.size(); i++)
+	{
+		if (m_CollidingArray[i] == other)
+		{
+			//if it is, then we swap it with the last one and then we pop
+			std::swap(m_CollidingArray[i], m_CollidingArray.back());
+			m_CollidingArray.pop_back();
+			return;
+		}
+	}
+}
+void MyRigidBody::ClearCollidingList(void)
+{
+	//keep the capacity, the set is refilled every frame
+	m_CollidingArray.clear();
+}
+void MyRigidBody::DetachCollidingList(void)
+{
+	for (uint i = 0; i < m_CollidingArray.size(); ++i)
 	{
-		memcpy(pTemp, m_CollidingArray, sizeof(MyRigidBody*) * m_nCollidingCount);
-		delete[] m_CollidingArray;
-		m_CollidingArray = nullptr;
+		m_CollidingArray[i]->RemoveCollisionWith(this);
 	}
-	pTemp[m_nCollidingCount] = other;
-	m_CollidingArray = pTemp;
+	m_CollidingArray.clear();
 
-	++m_nCollidingCount;
+	//an axis is only worth keeping while the boxes overlap, otherwise the pair never reaches the SAT
+	vector3 v3Min = GetMinSwept();
+	vector3 v3Max = GetMaxSwept();
+	for (uint i = 0; i < m_SeparatingArray.size();)
+	{
+		MyRigidBody* pOther = m_SeparatingArray[i].m_pOther;
+		vector3 v3OtherMin = pOther->GetMinSwept();
+		vector3 v3OtherMax = pOther->GetMaxSwept();
+		if (v3Max.x >= v3OtherMin.x && v3Min.x <= v3OtherMax.x &&
+			v3Max.y >= v3OtherMin.y && v3Min.y <= v3OtherMax.y &&
+			v3Max.z >= v3OtherMin.z && v3Min.z <= v3OtherMax.z)
+		{
+			++i;
+			continue;
+		}
+		pOther->ForgetSeparatingAxis(this);
+		m_SeparatingArray[i] = m_SeparatingArray.back();
+		m_SeparatingArray.pop_back();
+	}
 }
-void MyRigidBody::RemoveCollisionWith(MyRigidBody* other)
+void MyRigidBody::SetSeparatingAxis(MyRigidBody* a_pOther, uint a_uAxis)
 {
-	//if there are no dimensions return
-	if (m_nCollidingCount == 0)
+	if (a_uAxis == eSATResults::SAT_NONE)
+	{
+		this->ForgetSeparatingAxis(a_pOther);
+		a_pOther->ForgetSeparatingAxis(this);
 		return;
+	}
 
-	//we look one by one if its the one wanted
-	for (uint i = 0; i < m_nCollidingCount; i++)
+	//overwrite the entry of the pair if both bodies already have one
+	for (uint i = 0; i < m_SeparatingArray.size(); ++i)
 	{
-		if (m_CollidingArray[i] == other)
+		if (m_SeparatingArray[i].m_pOther == a_pOther)
 		{
-			//if it is, then we swap it with the last one and then we pop
-			std::swap(m_CollidingArray[i], m_CollidingArray[m_nCollidingCount - 1]);
-			PRigidBody* pTemp;
-			pTemp = new PRigidBody[m_nCollidingCount - 1];
-			if (m_CollidingArray)
+			m_SeparatingArray[i].m_uAxis = a_uAxis;
+			for (uint j = 0; j < a_pOther->m_SeparatingArray.size(); ++j)
 			{
-				memcpy(pTemp, m_CollidingArray, sizeof(uint) * (m_nCollidingCount - 1));
-				delete[] m_CollidingArray;
-				m_CollidingArray = nullptr;
+				if (a_pOther->m_SeparatingArray[j].m_pOther == this)
+					a_pOther->m_SeparatingArray[j].m_uAxis = a_uAxis;
 			}
-			m_CollidingArray = pTemp;
-
-			--m_nCollidingCount;
 			return;
 		}
 	}
+	this->m_SeparatingArray.push_back({ a_pOther, a_uAxis });
+	a_pOther->m_SeparatingArray.push_back({ this, a_uAxis });
 }
-void MyRigidBody::ClearCollidingList(void)
+uint MyRigidBody::GetSeparatingAxis(MyRigidBody* const a_pOther)
 {
-	m_nCollidingCount = 0;
-	if (m_CollidingArray)
+	for (uint i = 0; i < m_SeparatingArray.size(); ++i)
 	{
-		delete[] m_CollidingArray;
-		m_CollidingArray = nullptr;
+		if (m_SeparatingArray[i].m_pOther == a_pOther)
+			return m_SeparatingArray[i].m_uAxis;
 	}
+	return eSATResults::SAT_NONE;
 }
-uint MyRigidBody::SAT(MyRigidBody* const a_pOther)
+void MyRigidBody::ForgetSeparatingAxis(MyRigidBody* const a_pOther)
 {
-	/*
-	Your code goes here instead of this comment;
-
-	For this method, if there is an axis that separates the two objects
-	then the return will be different than 0; 1 for any separating axis
-	is ok if you are not going for the extra credit, if you could not
-	find a separating axis you need to return 0, there is an enum in
-	Simplex that might help you [eSATResults] feel free to use it.
-	(eSATResults::SAT_NONE has a value of 0)
-	*/
+	for (uint i = 0; i < m_SeparatingArray.size(); ++i)
+	{
+		if (m_SeparatingArray[i].m_pOther == a_pOther)
+		{
+			m_SeparatingArray[i] = m_SeparatingArray.back();
+			m_SeparatingArray.pop_back();
+			return;
+		}
+	}
+}
+void MyRigidBody::GetSATFrame(MyRigidBody* const a_pOther, SATFrame& a_Frame)
+{
+	//the oriented boxes were taken out of the model matrices when they were set
+	for (uint i = 0; i < 3; ++i)
+	{
+		a_Frame.m_v3AxisA[i] = this->m_v3AxisG[i];
+		a_Frame.m_v3AxisB[i] = a_pOther->m_v3AxisG[i];
+	}
+	a_Frame.m_v3HalfA = this->m_v3HalfWidthG;
+	a_Frame.m_v3HalfB = a_pOther->m_v3HalfWidthG;
 
-	//there is no axis test that separates this two objects
-	return 0;
+	//axes of the second box in the frame of the first one, the epsilon keeps parallel
+	//edges from making a cross product axis that separates everything
+	for (uint i = 0; i < 3; ++i)
+	{
+		for (uint j = 0; j < 3; ++j)
+		{
+			a_Frame.m_fRot[i][j] = glm::dot(a_Frame.m_v3AxisA[i], a_Frame.m_v3AxisB[j]);
+			a_Frame.m_fAbsRot[i][j] = std::abs(a_Frame.m_fRot[i][j]) + FLT_EPSILON;
+		}
+	}
+
+	//distance between the centers, also in the frame of the first box
+	a_Frame.m_v3Distance = a_pOther->m_v3CenterG - this->m_v3CenterG;
+	a_Frame.m_v3Trans = vector3(glm::dot(a_Frame.m_v3Distance, a_Frame.m_v3AxisA[0]),
+		glm::dot(a_Frame.m_v3Distance, a_Frame.m_v3AxisA[1]), glm::dot(a_Frame.m_v3Distance, a_Frame.m_v3AxisA[2]));
 }
-bool MyRigidBody::IsColliding(MyRigidBody* const a_pOther)
+float MyRigidBody::GetSATGap(SATFrame const& a_Frame, uint a_uAxis, float& a_fLength)
 {
-	//check if spheres are colliding
-	bool bColliding = true;
-	//bColliding = (glm::distance(GetCenterGlobal(), other->GetCenterGlobal()) < m_fRadius + other->m_fRadius);
-	//if they are check the Axis Aligned Bounding Box
-	if (bColliding) //they are colliding with bounding sphere
+	float const (&fRot)[3][3] = a_Frame.m_fRot;
+	float const (&fAbsRot)[3][3] = a_Frame.m_fAbsRot;
+	vector3 const& v3Trans = a_Frame.m_v3Trans;
+	vector3 const& v3HalfA = a_Frame.m_v3HalfA;
+	vector3 const& v3HalfB = a_Frame.m_v3HalfB;
+	float fRadiusA, fRadiusB, fDistance;
+
+	if (a_uAxis <= eSATResults::SAT_AZ)
+	{
+		//AX/AY/AZ
+		uint i = a_uAxis - eSATResults::SAT_AX;
+		fRadiusA = v3HalfA[i];
+		fRadiusB = v3HalfB[0] * fAbsRot[i][0] + v3HalfB[1] * fAbsRot[i][1] + v3HalfB[2] * fAbsRot[i][2];
+		fDistance = v3Trans[i];
+		a_fLength = 1.0f;
+	}
+	else if (a_uAxis <= eSATResults::SAT_BZ)
+	{
+		//BX/BY/BZ
+		uint i = a_uAxis - eSATResults::SAT_BX;
+		fRadiusA = v3HalfA[0] * fAbsRot[0][i] + v3HalfA[1] * fAbsRot[1][i] + v3HalfA[2] * fAbsRot[2][i];
+		fRadiusB = v3HalfB[i];
+		fDistance = v3Trans[0] * fRot[0][i] + v3Trans[1] * fRot[1][i] + v3Trans[2] * fRot[2][i];
+		a_fLength = 1.0f;
+	}
+	else
 	{
-		if (this->m_v3MaxG.x < a_pOther->m_v3MinG.x) //this to the right of other
-			bColliding = false;
-		if (this->m_v3MinG.x > a_pOther->m_v3MaxG.x) //this to the left of other
-			bColliding = false;
+		//the 9 cross products, AX/BX, AX/BY ... AZ/BZ
+		uint i = (a_uAxis - eSATResults::SAT_AXxBX) / 3;
+		uint j = (a_uAxis - eSATResults::SAT_AXxBX) % 3;
+		uint i1 = (i + 1) % 3;
+		uint i2 = (i + 2) % 3;
+		uint j1 = (j + 1) % 3;
+		uint j2 = (j + 2) % 3;
+		fRadiusA = v3HalfA[i1] * fAbsRot[i2][j] + v3HalfA[i2] * fAbsRot[i1][j];
+		fRadiusB = v3HalfB[j1] * fAbsRot[i][j2] + v3HalfB[j2] * fAbsRot[i][j1];
+		fDistance = v3Trans[i2] * fRot[i1][j] - v3Trans[i1] * fRot[i2][j];
+		//both axes are unit so the cross product is as long as the sine between them
+		a_fLength = std::sqrt(std::max(0.0f, 1.0f - fRot[i][j] * fRot[i][j]));
+	}
+	return std::abs(fDistance) - (fRadiusA + fRadiusB);
+}
+vector3 MyRigidBody::GetSATNormal(SATFrame const& a_Frame, uint a_uAxis)
+{
+	vector3 v3Normal;
+	if (a_uAxis <= eSATResults::SAT_AZ)
+		v3Normal = a_Frame.m_v3AxisA[a_uAxis - eSATResults::SAT_AX];
+	else if (a_uAxis <= eSATResults::SAT_BZ)
+		v3Normal = a_Frame.m_v3AxisB[a_uAxis - eSATResults::SAT_BX];
+	else
+	{
+		uint i = (a_uAxis - eSATResults::SAT_AXxBX) / 3;
+		uint j = (a_uAxis - eSATResults::SAT_AXxBX) % 3;
+		v3Normal = glm::normalize(glm::cross(a_Frame.m_v3AxisA[i], a_Frame.m_v3AxisB[j]));
+	}
+	//from the first box to the second one
+	if (glm::dot(v3Normal, a_Frame.m_v3Distance) < 0.0f)
+		v3Normal = -v3Normal;
+	return v3Normal;
+}
+uint MyRigidBody::SAT(MyRigidBody* const a_pOther, uint a_uFirstAxis)
+{
+	SATFrame frame;
+	GetSATFrame(a_pOther, frame);
 
-		if (this->m_v3MaxG.y < a_pOther->m_v3MinG.y) //this below of other
-			bColliding = false;
-		if (this->m_v3MinG.y > a_pOther->m_v3MaxG.y) //this above of other
-			bColliding = false;
+	//the axis that separated the pair last time is likely to still do it
+	float fLength = 0.0f;
+	bool bFirst = a_uFirstAxis != eSATResults::SAT_NONE && a_uFirstAxis <= eSATResults::SAT_AZxBZ;
+	if (bFirst && GetSATGap(frame, a_uFirstAxis, fLength) > 0.0f)
+		return a_uFirstAxis;
 
-		if (this->m_v3MaxG.z < a_pOther->m_v3MinG.z) //this behind of other
-			bColliding = false;
-		if (this->m_v3MinG.z > a_pOther->m_v3MaxG.z) //this in front of other
-			bColliding = false;
+	//Test AX/AY/AZ, then BX/BY/BZ and then the 9 cross products
+	for (uint uAxis = eSATResults::SAT_AX; uAxis <= eSATResults::SAT_AZxBZ; ++uAxis)
+	{
+		if (bFirst && uAxis == a_uFirstAxis)
+			continue;
+		if (GetSATGap(frame, uAxis, fLength) > 0.0f)
+			return uAxis;
+	}
 
-		if (bColliding) //they are colliding with bounding box also
+	//there is no axis test that separates this two objects
+	return eSATResults::SAT_NONE;
+}
+bool MyRigidBody::SATContact(MyRigidBody* const a_pOther, uint& a_uAxis, float& a_fDepth, vector3& a_v3Normal, uint a_uFirstAxis)
+{
+	SATFrame frame;
+	GetSATFrame(a_pOther, frame);
+
+	float fLength = 0.0f;
+	if (a_uFirstAxis != eSATResults::SAT_NONE && a_uFirstAxis <= eSATResults::SAT_AZxBZ &&
+		GetSATGap(frame, a_uFirstAxis, fLength) > 0.0f)
+	{
+		a_uAxis = a_uFirstAxis;
+		a_fDepth = 0.0f;
+		a_v3Normal = GetSATNormal(frame, a_uAxis);
+		return false;
+	}
+
+	//an overlap has to be confirmed on every axis, keep the shallowest one on the way
+	a_uAxis = eSATResults::SAT_NONE;
+	a_fDepth = FLT_MAX;
+	for (uint uAxis = eSATResults::SAT_AX; uAxis <= eSATResults::SAT_AZxBZ; ++uAxis)
+	{
+		float fGap = GetSATGap(frame, uAxis, fLength);
+		if (fGap > 0.0f)
 		{
-			this->AddCollisionWith(a_pOther);
-			a_pOther->AddCollisionWith(this);
+			a_uAxis = uAxis;
+			a_fDepth = 0.0f;
+			a_v3Normal = GetSATNormal(frame, a_uAxis);
+			return false;
 		}
-		else //they are not colliding with bounding box
+		//the cross product of nearly parallel edges has no direction worth pushing along
+		if (fLength < 1e-3f)
+			continue;
+		if (-fGap / fLength < a_fDepth)
 		{
-			this->RemoveCollisionWith(a_pOther);
-			a_pOther->RemoveCollisionWith(this);
+			a_uAxis = uAxis;
+			a_fDepth = -fGap / fLength;
 		}
 	}
-	else //they are not colliding with bounding sphere
+	a_v3Normal = GetSATNormal(frame, a_uAxis);
+	return true;
+}
+bool MyRigidBody::IsColliding(MyRigidBody* const a_pOther)
+{
+	uint uAxis = eSATResults::SAT_NONE;
+	bool bColliding = TestCollision(a_pOther, &uAxis);
+	if (bColliding)
+	{
+		this->AddCollisionWith(a_pOther);
+		a_pOther->AddCollisionWith(this);
+	}
+	else
 	{
 		this->RemoveCollisionWith(a_pOther);
 		a_pOther->RemoveCollisionWith(this);
 	}
+	//keep the axis for the next test, a collision means there is none to keep
+	if (bColliding || uAxis != eSATResults::SAT_NONE)
+		SetSeparatingAxis(a_pOther, uAxis);
 	return bColliding;
 }
+bool MyRigidBody::TestCollision(MyRigidBody* const a_pOther, uint* a_pAxis)
+{
+	if (a_pAxis != nullptr)
+		*a_pAxis = eSATResults::SAT_NONE;
+
+
+	//a continuous body is first tested along its move
+	if (m_bContinuous || a_pOther->m_bContinuous)
+	{
+		float fEnter = 0.0f;
+		float fExit = 0.0f;
+		if (!GetSweptInterval(a_pOther, fEnter, fExit))
+		{
+			m_uTierCount[CT_ARBB].fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		//the boxes met and were apart again before the end of the move, a test of where
+		//the bodies ended would let them pass through each other
+		if (fExit < 1.0f)
+		{
+			m_uTierCount[CT_COLLIDING].fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	//check if spheres are colliding, a single dot product settles most of the pairs
+	vector3 v3Distance = a_pOther->m_v3CenterG - m_v3CenterG;
+	float fRadii = m_fRadiusG + a_pOther->m_fRadiusG;
+	if (glm::dot(v3Distance, v3Distance) > fRadii * fRadii)
+	{
+		m_uTierCount[CT_SPHERE].fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	//if they are check the Axis Aligned Bounding Box
+	if (this->m_v3MaxG.x < a_pOther->m_v3MinG.x || //this to the right of other
+		this->m_v3MinG.x > a_pOther->m_v3MaxG.x || //this to the left of other
+		this->m_v3MaxG.y < a_pOther->m_v3MinG.y || //this below of other
+		this->m_v3MinG.y > a_pOther->m_v3MaxG.y || //this above of other
+		this->m_v3MaxG.z < a_pOther->m_v3MinG.z || //this behind of other
+		this->m_v3MinG.z > a_pOther->m_v3MaxG.z) //this in front of other
+	{
+		m_uTierCount[CT_ARBB].fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	//and only then look for an axis that separates the oriented boxes, starting with the one
+	//that separated them last time; the pair is always seen from the body that goes first in
+	//memory so the axis keeps its meaning
+	bool bOtherFirst = std::less<MyRigidBody*>()(a_pOther, this);
+	MyRigidBody* pFirst = bOtherFirst ? a_pOther : this;
+	MyRigidBody* pSecond = bOtherFirst ? this : a_pOther;
+	uint uAxis = pFirst->SAT(pSecond, GetSeparatingAxis(a_pOther));
+	if (uAxis != eSATResults::SAT_NONE)
+	{
+		if (a_pAxis != nullptr)
+			*a_pAxis = uAxis;
+		m_uTierCount[CT_SAT].fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_uTierCount[CT_COLLIDING].fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+bool MyRigidBody::GetSweptInterval(MyRigidBody* const a_pOther, float& a_fEnter, float& a_fExit)
+{
+	//a body that is not continuous is taken as still where it is
+	vector3 v3MinA = m_bContinuous ? m_v3MinGPrev : m_v3MinG;
+	vector3 v3MaxA = m_bContinuous ? m_v3MaxGPrev : m_v3MaxG;
+	vector3 v3MinB = a_pOther->m_bContinuous ? a_pOther->m_v3MinGPrev : a_pOther->m_v3MinG;
+	vector3 v3MaxB = a_pOther->m_bContinuous ? a_pOther->m_v3MaxGPrev : a_pOther->m_v3MaxG;
+
+	a_fEnter = 0.0f;
+	a_fExit = 1.0f;
+	for (uint i = 0; i < 3; ++i)
+	{
+		//the boxes overlap on an axis while both gaps are not negative, each gap is
+		//linear over the move: fGap + t * fSlope >= 0
+		float fGap[2] = { v3MaxA[i] - v3MinB[i], v3MaxB[i] - v3MinA[i] };
+		float fSlope[2] = {
+			(m_v3MaxG[i] - v3MaxA[i]) - (a_pOther->m_v3MinG[i] - v3MinB[i]),
+			(a_pOther->m_v3MaxG[i] - v3MaxB[i]) - (m_v3MinG[i] - v3MinA[i]) };
+		for (uint j = 0; j < 2; ++j)
+		{
+			if (fSlope[j] == 0.0f)
+			{
+				if (fGap[j] < 0.0f)
+					return false;
+			}
+			else if (fSlope[j] > 0.0f)
+				a_fEnter = std::max(a_fEnter, -fGap[j] / fSlope[j]);
+			else
+				a_fExit = std::min(a_fExit, -fGap[j] / fSlope[j]);
+		}
+		if (a_fEnter > a_fExit)
+			return false;
+	}
+	return true;
+}
+float MyRigidBody::GetTimeOfImpact(MyRigidBody* const a_pOther)
+{
+	float fEnter = 0.0f;
+	float fExit = 0.0f;
+	if (!GetSweptInterval(a_pOther, fEnter, fExit))
+		return -1.0f;
+	return fEnter;
+}
+uint MyRigidBody::GetTierCount(eCollisionTier a_eTier)
+{
+	if (a_eTier >= CT_COUNT)
+		return 0;
+	return m_uTierCount[a_eTier].load(std::memory_order_relaxed);
+}
+void MyRigidBody::ResetTierCount(void)
+{
+	for (uint i = 0; i < CT_COUNT; ++i)
+	{
+		m_uTierCount[i].store(0, std::memory_order_relaxed);
+	}
+}
 
 void MyRigidBody::AddToRenderList(void)
 {
 	if (m_bVisibleBS)
 	{
-		if (m_nCollidingCount > 0)
+		if (m_CollidingArray.size() > 0)
 			m_pMeshMngr->AddWireSphereToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(vector3(m_fRadius)), C_BLUE_CORNFLOWER);
 		else
 			m_pMeshMngr->AddWireSphereToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(vector3(m_fRadius)), C_BLUE_CORNFLOWER);
 	}
 	if (m_bVisibleOBB)
 	{
-		if (m_nCollidingCount > 0)
+		if (m_CollidingArray.size() > 0)
 			m_pMeshMngr->AddWireCubeToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(m_v3HalfWidth * 2.0f), m_v3ColorColliding);
 		else
 			m_pMeshMngr->AddWireCubeToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(m_v3HalfWidth * 2.0f), m_v3ColorNotColliding);
 	}
 	if (m_bVisibleARBB)
 	{
-		if (m_nCollidingCount > 0)
+		if (m_CollidingArray.size() > 0)
 			m_pMeshMngr->AddWireCubeToRenderList(glm::translate(m_v3CenterG) * glm::scale(m_v3ARBBSize), C_YELLOW);
 		else
 			m_pMeshMngr->AddWireCubeToRenderList(glm::translate(m_v3CenterG) * glm::scale(m_v3ARBBSize), C_YELLOW);
@@ -360,7 +756,7 @@ void MyRigidBody::AddToRenderList(void)
 bool MyRigidBody::IsInCollidingArray(MyRigidBody* a_pEntry)
 {
 	//see if the entry is in the set
-	for (uint i = 0; i < m_nCollidingCount; i++)
+	for (uint i = 0; i < m_CollidingArray.size(); i++)
 	{
 		if (m_CollidingArray[i] == a_pEntry)
 			return true;
@@ -6,14 +6,46 @@ Date: 2017/06
 #define __MYRIGIDBODY_H_
 
 #include "Simplex\Mesh\Model.h"
+#include <atomic>
 
 namespace Simplex
 {
 
+//Stage of the collision test that settled a pair, TestCollision counts the pairs settled by each
+enum eCollisionTier
+{
+	CT_SPHERE = 0, //rejected by the bounding spheres
+	CT_ARBB, //rejected by the axis (re)aligned bounding boxes
+	CT_SAT, //rejected by the separating axis test of the oriented bounding boxes
+	CT_COLLIDING, //passed every test
+	CT_COUNT //number of tiers
+};
+
 //System Class
 class MyRigidBody
 {
 	typedef MyRigidBody* PRigidBody; //Entity Pointer
+
+	//Oriented boxes of a pair seen from the first one, shared by every axis of the separating axis test
+	struct SATFrame
+	{
+		vector3 m_v3AxisA[3]; //unit axes of the first box in global space
+		vector3 m_v3AxisB[3]; //unit axes of the second box in global space
+		vector3 m_v3HalfA; //half widths of the first box along its axes
+		vector3 m_v3HalfB; //half widths of the second box along its axes
+		vector3 m_v3Distance; //from the center of the first box to the second one in global space
+		vector3 m_v3Trans; //same distance in the frame of the first box
+		float m_fRot[3][3]; //axes of the second box in the frame of the first one
+		float m_fAbsRot[3][3]; //absolute values of m_fRot plus an epsilon for parallel edges
+	};
+
+	//Axis that separated the oriented boxes of a pair the last time the SAT ran on it
+	struct SeparatingAxis
+	{
+		PRigidBody m_pOther; //other body of the pair
+		uint m_uAxis; //axis (eSATResults) seen from the body of the pair that goes first in memory
+	};
+
 	MeshManager* m_pMeshMngr = nullptr; //for displaying the Rigid Body
 
 	bool m_bVisibleBS = false; //Visibility of bounding sphere
@@ -21,6 +53,7 @@ class MyRigidBody
 	bool m_bVisibleARBB = true; //Visibility of axis (Re)aligned bounding box
 
 	float m_fRadius = 0.0f; //Radius
+	float m_fRadiusG = 0.0f; //Radius in global space (scaled by the model matrix)
 
 	vector3 m_v3ColorColliding = C_RED; //Color when colliding
 	vector3 m_v3ColorNotColliding = C_WHITE; //Color when not colliding
@@ -34,13 +67,24 @@ class MyRigidBody
 	vector3 m_v3MinG = ZERO_V3; //minimum coordinate in global space (for ARBB)
 	vector3 m_v3MaxG = ZERO_V3; //maximum coordinate in global space (for ARBB)
 
+	bool m_bContinuous = false; //is the body tested along its last move instead of only where it ended?
+	vector3 m_v3MinGPrev = ZERO_V3; //minimum of the global box before the last move
+	vector3 m_v3MaxGPrev = ZERO_V3; //maximum of the global box before the last move
+
 	vector3 m_v3HalfWidth = ZERO_V3; //half the size of the Oriented Bounding Box
 	vector3 m_v3ARBBSize = ZERO_V3;// size of the Axis (Re)Alligned Bounding Box
 
+	vector3 m_v3AxisG[3] = { AXIS_X, AXIS_Y, AXIS_Z }; //unit axes of the Oriented Bounding Box in global space
+	vector3 m_v3HalfWidthG = ZERO_V3; //half the size of the Oriented Bounding Box along its global axes (scaled)
+
 	matrix4 m_m4ToWorld = IDENTITY_M4; //Matrix that will take us from local to world coordinate
+	uint m_uVersion = 0; //stamp of the last change of the model matrix, unique among every rigid body
+
+	std::vector<PRigidBody> m_CollidingArray; //rigid bodies this one is colliding with, keeps its capacity when cleared
+	std::vector<SeparatingAxis> m_SeparatingArray; //pairs with an overlapping box the SAT separated last time, kept on both bodies
 
-	uint m_nCollidingCount = 0; //size of the colliding set
-	PRigidBody* m_CollidingArray = nullptr; //array of rigid bodies this one is colliding with
+	static std::atomic<uint> m_uTierCount[CT_COUNT]; //pairs settled by each tier of TestCollision since the last reset
+	static uint m_uVersionClock; //last stamp given to a rigid body
 
 public:
 	/*
@@ -82,11 +126,28 @@ public:
 	void AddToRenderList(void);
 
 	/*
-	USAGE: Clears the colliding list
+	USAGE: Clears the colliding list, its memory is kept for the next frame
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
 	void ClearCollidingList(void);
+	/*
+	USAGE: Removes this rigid body from the colliding list of every body it collides with,
+	then clears its own; the separating axes of the bodies its box no longer overlaps are
+	forgotten as well
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void DetachCollidingList(void);
+	/*
+	USAGE: Keeps the axis that separated this body and the incoming one for the next test
+	of the pair, both bodies hold it
+	ARGUMENTS:
+	-	MyRigidBody* other -> other rigid body of the pair
+	-	uint a_uAxis -> axis given by TestCollision, SAT_NONE forgets the one kept
+	OUTPUT: ---
+	*/
+	void SetSeparatingAxis(MyRigidBody* other, uint a_uAxis);
 
 	/*
 	USAGE: Mark collision with the incoming Rigid Body
@@ -108,6 +169,49 @@ public:
 	OUTPUT: are they colliding?
 	*/
 	bool IsColliding(MyRigidBody* const other);
+	/*
+	USAGE: Tells if the object is colliding with the incoming one without touching the
+	colliding set or the separating axes of either, so it is safe to call from several
+	threads at once
+	ARGUMENTS:
+	-	MyRigidBody* const other -> inspected rigid body
+	-	uint* a_pAxis = nullptr -> (output) if given, the axis the SAT separated them along,
+		SAT_NONE if they collide or the SAT did not run
+	OUTPUT: are they colliding?
+	*/
+	bool TestCollision(MyRigidBody* const other, uint* a_pAxis = nullptr);
+	/*
+	USAGE: Finds the earliest point of the last move of both rigid bodies where their global
+	boxes touch, each box is taken to slide linearly from where it was to where it is
+	ARGUMENTS: MyRigidBody* const other -> inspected rigid body
+	OUTPUT: fraction of the move (0 at the previous box, 1 at the current one), -1 if the
+	boxes never touched
+	*/
+	float GetTimeOfImpact(MyRigidBody* const other);
+	/*
+	USAGE: Runs the separating axis test on every axis to describe how the oriented boxes touch
+	ARGUMENTS:
+	-	MyRigidBody* const other -> inspected rigid body
+	-	uint& a_uAxis -> (output) if they overlap the axis (eSATResults) they penetrate the least
+		along, otherwise the axis that separates them
+	-	float& a_fDepth -> (output) how far they penetrate along that axis, 0 if they are apart
+	-	vector3& a_v3Normal -> (output) unit axis in global space, pointing from this body to the other
+	-	uint a_uFirstAxis = SAT_NONE -> axis to try first, like the one that separated them last
+	OUTPUT: do the oriented boxes overlap?
+	*/
+	bool SATContact(MyRigidBody* const other, uint& a_uAxis, float& a_fDepth, vector3& a_v3Normal, uint a_uFirstAxis = eSATResults::SAT_NONE);
+	/*
+	USAGE: Gets how many pairs the specified tier of TestCollision settled since the last reset
+	ARGUMENTS: eCollisionTier a_eTier -> queried tier
+	OUTPUT: pair count
+	*/
+	static uint GetTierCount(eCollisionTier a_eTier);
+	/*
+	USAGE: Sets the pair count of every tier back to zero
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	static void ResetTierCount(void);
 #pragma region Accessors
 	/*
 	Usage: Gets visibility of bounding sphere
@@ -212,6 +316,40 @@ public:
 	*/
 	vector3 GetMaxGlobal(void);
 	/*
+	Usage: Sets whether the body is tested along its last move, so it cannot pass through
+	another one between two updates; the sweep starts at the current position
+	Arguments: bool a_bContinuous -> test continuously?
+	Output: ---
+	*/
+	void SetContinuous(bool a_bContinuous);
+	/*
+	Usage: Starts the next move of the body where it is now, so the sweep covers every
+	matrix set from here to the next call; the Entity Manager calls it once per update
+	Arguments: ---
+	Output: did the swept box change? (only for continuous bodies)
+	*/
+	bool BeginStep(void);
+	/*
+	Usage: Tells whether the body is tested along its last move
+	Arguments: ---
+	Output: is it tested continuously?
+	*/
+	bool IsContinuous(void);
+	/*
+	Usage: Gets minimum vector of the box swept by the last move in global space, the
+	global one if the body is not continuous
+	Arguments: ---
+	Output: min vector
+	*/
+	vector3 GetMinSwept(void);
+	/*
+	Usage: Gets maximum vector of the box swept by the last move in global space, the
+	global one if the body is not continuous
+	Arguments: ---
+	Output: max vector
+	*/
+	vector3 GetMaxSwept(void);
+	/*
 	Usage: Gets the size of the model divided by 2
 	Arguments: ---
 	Output: halfwidth vector
@@ -224,7 +362,15 @@ public:
 	*/
 	matrix4 GetModelMatrix(void);
 	/*
-	Usage: Sets Model to World matrix
+	Usage: Gets the stamp of the last change of the model matrix, it changes every time the
+	matrix does and no two rigid bodies share one
+	Arguments: ---
+	Output: version stamp
+	*/
+	uint GetVersion(void);
+	/*
+	Usage: Sets Model to World matrix, a continuous body sweeps from where it was at the
+	last BeginStep no matter how many times the matrix is set in between
 	Arguments: Model to World matrix
 	Output: ---
 	*/
@@ -236,6 +382,29 @@ public:
 	OUTPUT: is it in the array?
 	*/
 	bool IsInCollidingArray(MyRigidBody* a_pEntry);
+	/*
+	USAGE: Computes the axis aligned box of a transformed box from its center and half
+	widths, each global extent is the half widths weighted by the absolute rotation
+	ARGUMENTS:
+	-	matrix4 const& a_m4ToWorld -> affine model to world matrix
+	-	vector3 const& a_v3CenterL -> center of the box in local space
+	-	vector3 const& a_v3HalfWidth -> half widths of the box in local space
+	-	vector3& a_v3MinG -> minimum of the global box (output)
+	-	vector3& a_v3MaxG -> maximum of the global box (output)
+	OUTPUT: ---
+	*/
+	static void ComputeGlobalBox(matrix4 const& a_m4ToWorld, vector3 const& a_v3CenterL, vector3 const& a_v3HalfWidth,
+		vector3& a_v3MinG, vector3& a_v3MaxG);
+	/*
+	USAGE: Sets the model matrix of every rigid body in the list, computing their global
+	boxes with vector instructions (a column of the matrix per register)
+	ARGUMENTS:
+	-	MyRigidBody* const* a_pRigidBody -> rigid bodies to update
+	-	matrix4 const* a_pModelMatrix -> model matrix of each rigid body
+	-	uint a_uCount -> number of rigid bodies
+	OUTPUT: ---
+	*/
+	static void SetModelMatrixBatch(MyRigidBody* const* a_pRigidBody, matrix4 const* a_pModelMatrix, uint a_uCount);
 	
 private:
 	/*
@@ -251,11 +420,67 @@ private:
 	*/
 	void Init(void);
 	/*
+	USAGE: Takes the oriented bounding box in global space and the radius of the sphere out
+	of the model matrix, so SAT does not need the matrix
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void UpdateOrientedBox(void);
+	/*
 	USAGE: This will apply the Separation Axis Test
-	ARGUMENTS: MyRigidBody* const a_pOther -> other rigid body to test against
+	ARGUMENTS:
+	-	MyRigidBody* const a_pOther -> other rigid body to test against
+	-	uint a_uFirstAxis = SAT_NONE -> axis to try before the others
 	OUTPUT: 0 for colliding, all other first axis that succeeds test
 	*/
-	uint SAT(MyRigidBody* const a_pOther);
+	uint SAT(MyRigidBody* const a_pOther, uint a_uFirstAxis = eSATResults::SAT_NONE);
+	/*
+	USAGE: Gathers the oriented boxes of this body and the other one for the separating axis test
+	ARGUMENTS:
+	-	MyRigidBody* const a_pOther -> other rigid body to test against
+	-	SATFrame& a_Frame -> (output) boxes of the pair
+	OUTPUT: ---
+	*/
+	void GetSATFrame(MyRigidBody* const a_pOther, SATFrame& a_Frame);
+	/*
+	USAGE: Measures the gap between the projections of both boxes on one axis of the test
+	ARGUMENTS:
+	-	SATFrame const& a_Frame -> boxes of the pair
+	-	uint a_uAxis -> axis (eSATResults, not SAT_NONE)
+	-	float& a_fLength -> (output) length of the axis, the cross products are not unit
+	OUTPUT: gap scaled by the length of the axis, positive if the axis separates the boxes
+	*/
+	static float GetSATGap(SATFrame const& a_Frame, uint a_uAxis, float& a_fLength);
+	/*
+	USAGE: Gets one axis of the test in global space pointing from the first box to the second
+	ARGUMENTS:
+	-	SATFrame const& a_Frame -> boxes of the pair
+	-	uint a_uAxis -> axis (eSATResults, not SAT_NONE)
+	OUTPUT: unit axis
+	*/
+	static vector3 GetSATNormal(SATFrame const& a_Frame, uint a_uAxis);
+	/*
+	USAGE: Gets the axis that separated this body and the other one last time
+	ARGUMENTS: MyRigidBody* const a_pOther -> other rigid body of the pair
+	OUTPUT: axis (eSATResults), SAT_NONE if none is kept
+	*/
+	uint GetSeparatingAxis(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Drops the separating axis of the pair from this body only
+	ARGUMENTS: MyRigidBody* const a_pOther -> other rigid body of the pair
+	OUTPUT: ---
+	*/
+	void ForgetSeparatingAxis(MyRigidBody* const a_pOther);
+	/*
+	USAGE: Finds the part of the last move of both rigid bodies where their global boxes
+	overlap, each bound slides linearly so every axis limits it to an interval
+	ARGUMENTS:
+	-	MyRigidBody* const a_pOther -> other rigid body to test against
+	-	float& a_fEnter -> fraction of the move where the boxes start touching (output)
+	-	float& a_fExit -> fraction of the move where they stop touching (output)
+	OUTPUT: did the boxes touch at all during the move?
+	*/
+	bool GetSweptInterval(MyRigidBody* const a_pOther, float& a_fEnter, float& a_fExit);
 };//class
 
 } //namespace Simplex
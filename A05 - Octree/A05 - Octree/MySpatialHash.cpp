@@ -0,0 +1,208 @@
+#include "MySpatialHash.h"
+using namespace Simplex;
+//  MySpatialHash
+void Simplex::MySpatialHash::Clear(void)
+{
+	m_fCellSize = 1.0f;
+	m_fInvCellSize = 1.0f;
+	m_lTable.clear();
+	m_lCellSlot.clear();
+	m_lCellCount.clear();
+	m_lCellStart.clear();
+	m_lEntryBox.clear();
+	m_lEntryCell.clear();
+	m_lCellBox.clear();
+	m_lCellBoxMin.clear();
+	m_lCellBoxMax.clear();
+	m_lLargeBox.clear();
+	m_lIsLarge.clear();
+	m_lBoxCell.clear();
+	m_lHalfWidth.clear();
+}
+void Simplex::MySpatialHash::SetCellScale(float a_fCellScale) { m_fCellScale = std::max(a_fCellScale, 1.0f); }
+float Simplex::MySpatialHash::GetCellSize(void) { return m_fCellSize; }
+uint Simplex::MySpatialHash::GetCellCount(void) { return m_lCellSlot.size(); }
+uint Simplex::MySpatialHash::GetLargeCount(void) { return m_lLargeBox.size(); }
+void Simplex::MySpatialHash::ComputeCellSize(MyAABBStore* a_pStore)
+{
+	uint uCount = a_pStore->GetCount();
+	m_lHalfWidth.resize(uCount);
+	for (uint i = 0; i < uCount; ++i)
+	{
+		vector3 v3HalfWidth = (a_pStore->GetMax(i) - a_pStore->GetMin(i)) / 2.0f;
+		m_lHalfWidth[i] = std::max(v3HalfWidth.x, std::max(v3HalfWidth.y, v3HalfWidth.z));
+	}
+	float fMedian = 0.0f;
+	if (uCount > 0)
+	{
+		std::nth_element(m_lHalfWidth.begin(), m_lHalfWidth.begin() + uCount / 2, m_lHalfWidth.end());
+		fMedian = m_lHalfWidth[uCount / 2];
+	}
+	//points would all fall in cells of size 0, any size works for them
+	m_fCellSize = fMedian > 0.0f ? 2.0f * fMedian * m_fCellScale : 1.0f;
+	m_fInvCellSize = 1.0f / m_fCellSize;
+}
+int Simplex::MySpatialHash::GetCell(float a_fValue)
+{
+	//far away boxes share the border cells instead of overflowing
+	float fCell = std::floor(a_fValue * m_fInvCellSize);
+	fCell = std::min(std::max(fCell, -536870912.0f), 536870912.0f);
+	return static_cast<int>(fCell);
+}
+uint Simplex::MySpatialHash::FindCell(int a_nX, int a_nY, int a_nZ)
+{
+	uint uMask = m_lTable.size() - 1;
+	uint uSlot = (static_cast<uint>(a_nX) * 73856093u ^ static_cast<uint>(a_nY) * 19349663u ^ static_cast<uint>(a_nZ) * 83492791u) & uMask;
+	//linear probing, the table is never more than half full
+	while (m_lTable[uSlot].m_uCell != static_cast<uint>(-1))
+	{
+		Slot const& slot = m_lTable[uSlot];
+		if (slot.m_nX == a_nX && slot.m_nY == a_nY && slot.m_nZ == a_nZ)
+			return slot.m_uCell;
+		uSlot = (uSlot + 1) & uMask;
+	}
+	Slot& slot = m_lTable[uSlot];
+	slot.m_nX = a_nX;
+	slot.m_nY = a_nY;
+	slot.m_nZ = a_nZ;
+	slot.m_uCell = m_lCellSlot.size();
+	m_lCellSlot.push_back(uSlot);
+	m_lCellCount.push_back(0);
+	return slot.m_uCell;
+}
+void Simplex::MySpatialHash::Update(MyAABBStore* a_pStore, std::vector<uint>& a_lPair)
+{
+	uint uCount = a_pStore->GetCount();
+	ComputeCellSize(a_pStore);
+
+	//find the cells of every box once, the table is sized once the entries are known
+	uint uEntryCount = 0;
+	m_lLargeBox.clear();
+	m_lIsLarge.assign(uCount, false);
+	m_lBoxCell.resize(uCount * 6);
+	for (uint i = 0; i < uCount; ++i)
+	{
+		vector3 v3Min = a_pStore->GetMin(i);
+		vector3 v3Max = a_pStore->GetMax(i);
+		int* pCell = m_lBoxCell.data() + i * 6;
+		for (uint uAxis = 0; uAxis < 3; ++uAxis)
+		{
+			pCell[uAxis] = GetCell(v3Min[uAxis]);
+			pCell[uAxis + 3] = GetCell(v3Max[uAxis]);
+		}
+		uint uSpanX = pCell[3] - pCell[0] + 1;
+		uint uSpanY = pCell[4] - pCell[1] + 1;
+		uint uSpanZ = pCell[5] - pCell[2] + 1;
+		if (uSpanX > m_uMaxBoxCells || uSpanY > m_uMaxBoxCells || uSpanZ > m_uMaxBoxCells || uSpanX * uSpanY * uSpanZ > m_uMaxBoxCells)
+		{
+			m_lLargeBox.push_back(i);
+			m_lIsLarge[i] = true;
+			continue;
+		}
+		uEntryCount += uSpanX * uSpanY * uSpanZ;
+	}
+
+	uint uTableSize = 16;
+	while (uTableSize < 2 * uEntryCount)
+		uTableSize *= 2;
+	m_lTable.assign(uTableSize, Slot());
+	m_lCellSlot.clear();
+	m_lCellCount.clear();
+
+	//count the boxes of each cell
+	m_lEntryBox.resize(uEntryCount);
+	m_lEntryCell.resize(uEntryCount);
+	uint uEntry = 0;
+	for (uint i = 0; i < uCount; ++i)
+	{
+		if (m_lIsLarge[i])
+			continue;
+		int const* pCell = m_lBoxCell.data() + i * 6;
+		for (int z = pCell[2]; z <= pCell[5]; ++z)
+		{
+			for (int y = pCell[1]; y <= pCell[4]; ++y)
+			{
+				for (int x = pCell[0]; x <= pCell[3]; ++x)
+				{
+					uint uCell = FindCell(x, y, z);
+					++m_lCellCount[uCell];
+					m_lEntryBox[uEntry] = i;
+					m_lEntryCell[uEntry] = uCell;
+					++uEntry;
+				}
+			}
+		}
+	}
+
+	//counting sort, each cell gets a contiguous run of the sorted list
+	uint uCellCount = m_lCellSlot.size();
+	m_lCellStart.resize(uCellCount + 1);
+	m_lCellStart[0] = 0;
+	for (uint i = 0; i < uCellCount; ++i)
+		m_lCellStart[i + 1] = m_lCellStart[i] + m_lCellCount[i];
+	m_lCellBox.resize(uEntryCount);
+	m_lCellBoxMin.resize(uEntryCount);
+	m_lCellBoxMax.resize(uEntryCount);
+	for (uint i = 0; i < uEntryCount; ++i)
+	{
+		uint uCell = m_lEntryCell[i];
+		uint uSorted = m_lCellStart[uCell] + --m_lCellCount[uCell];
+		m_lCellBox[uSorted] = m_lEntryBox[i];
+		m_lCellBoxMin[uSorted] = a_pStore->GetMin(m_lEntryBox[i]);
+		m_lCellBoxMax[uSorted] = a_pStore->GetMax(m_lEntryBox[i]);
+	}
+
+	//two boxes can share several cells, the pair is only reported by the cell holding the
+	//minimum corner of their overlap, which is the largest of their first cells
+	for (uint i = 0; i < uCellCount; ++i)
+	{
+		Slot const& slot = m_lTable[m_lCellSlot[i]];
+		uint uEnd = m_lCellStart[i + 1];
+		for (uint j = m_lCellStart[i]; j + 1 < uEnd; ++j)
+		{
+			vector3 const& v3Min = m_lCellBoxMin[j];
+			vector3 const& v3Max = m_lCellBoxMax[j];
+			int const* pCell = m_lBoxCell.data() + m_lCellBox[j] * 6;
+			for (uint k = j + 1; k < uEnd; ++k)
+			{
+				vector3 const& v3OtherMin = m_lCellBoxMin[k];
+				vector3 const& v3OtherMax = m_lCellBoxMax[k];
+				if (v3Max.x < v3OtherMin.x || v3Min.x > v3OtherMax.x ||
+					v3Max.y < v3OtherMin.y || v3Min.y > v3OtherMax.y ||
+					v3Max.z < v3OtherMin.z || v3Min.z > v3OtherMax.z)
+					continue;
+				int const* pOtherCell = m_lBoxCell.data() + m_lCellBox[k] * 6;
+				if (std::max(pCell[0], pOtherCell[0]) != slot.m_nX || std::max(pCell[1], pOtherCell[1]) != slot.m_nY ||
+					std::max(pCell[2], pOtherCell[2]) != slot.m_nZ)
+					continue;
+				a_lPair.push_back(m_lCellBox[j]);
+				a_lPair.push_back(m_lCellBox[k]);
+			}
+		}
+	}
+
+	LargePairs(a_pStore, a_lPair);
+}
+void Simplex::MySpatialHash::LargePairs(MyAABBStore* a_pStore, std::vector<uint>& a_lPair)
+{
+	uint uCount = a_pStore->GetCount();
+	for (uint i = 0; i < m_lLargeBox.size(); ++i)
+	{
+		uint uBox = m_lLargeBox[i];
+		vector3 v3Min = a_pStore->GetMin(uBox);
+		vector3 v3Max = a_pStore->GetMax(uBox);
+		for (uint j = 0; j < uCount; j += MyAABBStore::m_uBatch)
+		{
+			uint uMask = a_pStore->OverlapMask(v3Min, v3Max, j, uCount - j);
+			for (uint k = 0; uMask != 0; ++k, uMask >>= 1)
+			{
+				//two large boxes meet once, from the lower index
+				uint uOther = j + k;
+				if ((uMask & 1) == 0 || uOther == uBox || (m_lIsLarge[uOther] && uOther < uBox))
+					continue;
+				a_lPair.push_back(uBox);
+				a_lPair.push_back(uOther);
+			}
+		}
+	}
+}
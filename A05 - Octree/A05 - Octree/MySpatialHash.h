@@ -0,0 +1,122 @@
+/*----------------------------------------------
+Programmer: Alberto Bobadilla (labigm@gmail.com)
+Date: 2017/07
+----------------------------------------------*/
+#ifndef __MYSPATIALHASH_H_
+#define __MYSPATIALHASH_H_
+
+#include "MyAABBStore.h"
+
+namespace Simplex
+{
+
+//Uniform grid hashed into a flat table, rebuilt every update. Suits boxes of similar size,
+//the cells are sized after the median box
+class MySpatialHash
+{
+	//entry of the table, maps a cell of the grid to its index among the cells in use
+	struct Slot
+	{
+		int m_nX = 0; //cell along x
+		int m_nY = 0; //cell along y
+		int m_nZ = 0; //cell along z
+		uint m_uCell = static_cast<uint>(-1); //index of the cell in use, -1 while the entry is empty
+	};
+
+	static const uint m_uMaxBoxCells = 64; //boxes that cover more cells are tested against every box instead
+
+	float m_fCellScale = 2.0f; //size of the cells relative to the median box width
+	float m_fCellSize = 1.0f; //size of the cells in global units
+	float m_fInvCellSize = 1.0f; //inverse of the cell size
+	std::vector<Slot> m_lTable; //open addressing table of the cells, its size is a power of two
+	std::vector<uint> m_lCellSlot; //table entry of each cell in use, in the order they were found
+	std::vector<uint> m_lCellCount; //boxes in each cell, spent again while sorting
+	std::vector<uint> m_lCellStart; //first box of each cell in the sorted list, one extra for the end
+	std::vector<uint> m_lEntryBox; //box of each (box, cell) entry
+	std::vector<uint> m_lEntryCell; //cell of each (box, cell) entry
+	std::vector<uint> m_lCellBox; //boxes sorted by cell
+	std::vector<vector3> m_lCellBoxMin; //minimum of each box sorted by cell
+	std::vector<vector3> m_lCellBoxMax; //maximum of each box sorted by cell
+	std::vector<uint> m_lLargeBox; //boxes that cover too many cells to be binned
+	std::vector<bool> m_lIsLarge; //is each box in the large list?
+	std::vector<int> m_lBoxCell; //first and last cell of each box, x y z of the first then of the last
+	std::vector<float> m_lHalfWidth; //scratch list the median half width is picked from
+public:
+	/*
+	USAGE: Forgets the cells, the memory is kept
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Clear(void);
+	/*
+	USAGE: Bins every box in the cells it overlaps and reports the overlapping pairs that share
+	a cell, each pair only once. The cell size is picked again from the median box
+	ARGUMENTS:
+	-	MyAABBStore* a_pStore -> boxes to bin
+	-	std::vector<uint>& a_lPair -> list the overlapping pairs are appended to, two
+		indices per pair
+	OUTPUT: ---
+	*/
+	void Update(MyAABBStore* a_pStore, std::vector<uint>& a_lPair);
+	/*
+	USAGE: Sets the size of the cells relative to the median box width
+	ARGUMENTS: float a_fCellScale -> scale, at least 1 so the median box covers at most two
+	cells per axis
+	OUTPUT: ---
+	*/
+	void SetCellScale(float a_fCellScale);
+	/*
+	USAGE: Gets the size of the cells used by the last update
+	ARGUMENTS: ---
+	OUTPUT: size in global units
+	*/
+	float GetCellSize(void);
+	/*
+	USAGE: Gets the number of cells that held a box in the last update
+	ARGUMENTS: ---
+	OUTPUT: cell count
+	*/
+	uint GetCellCount(void);
+	/*
+	USAGE: Gets the number of boxes that covered too many cells and were tested against every
+	box in the last update
+	ARGUMENTS: ---
+	OUTPUT: large box count
+	*/
+	uint GetLargeCount(void);
+
+private:
+	/*
+	USAGE: Sets the cell size from the median of the largest half width of the boxes
+	ARGUMENTS: MyAABBStore* a_pStore -> boxes to measure
+	OUTPUT: ---
+	*/
+	void ComputeCellSize(MyAABBStore* a_pStore);
+	/*
+	USAGE: Gets the cell a coordinate falls in along one axis
+	ARGUMENTS: float a_fValue -> coordinate in global space
+	OUTPUT: cell along the axis
+	*/
+	int GetCell(float a_fValue);
+	/*
+	USAGE: Finds the index of a cell among the cells in use, adding it if it is new
+	ARGUMENTS:
+	-	int a_nX -> cell along x
+	-	int a_nY -> cell along y
+	-	int a_nZ -> cell along z
+	OUTPUT: index of the cell
+	*/
+	uint FindCell(int a_nX, int a_nY, int a_nZ);
+	/*
+	USAGE: Reports the pairs between the boxes that were too large to bin and every other box
+	ARGUMENTS:
+	-	MyAABBStore* a_pStore -> boxes of the update
+	-	std::vector<uint>& a_lPair -> list the pairs are appended to
+	OUTPUT: ---
+	*/
+	void LargePairs(MyAABBStore* a_pStore, std::vector<uint>& a_lPair);
+};//class
+
+} //namespace Simplex
+
+#endif //__MYSPATIALHASH_H_
@@ -0,0 +1,109 @@
+#include "MySweepAndPrune.h"
+using namespace Simplex;
+//  MySweepAndPrune
+void Simplex::MySweepAndPrune::Clear(void)
+{
+	m_uAxis = 0;
+	m_lIndex.clear();
+	m_lMin.clear();
+	m_lMax.clear();
+	m_uSwapCount = 0;
+}
+uint Simplex::MySweepAndPrune::GetAxis(void) { return m_uAxis; }
+uint Simplex::MySweepAndPrune::GetSwapCount(void) { return m_uSwapCount; }
+void Simplex::MySweepAndPrune::Rebuild(MyAABBStore* a_pStore)
+{
+	uint uCount = a_pStore->GetCount();
+
+	//sort along the axis with the largest variance so the sweep sees the fewest false pairs
+	vector3 v3Sum = ZERO_V3;
+	vector3 v3SumSquared = ZERO_V3;
+	for (uint i = 0; i < uCount; ++i)
+	{
+		vector3 v3Center = (a_pStore->GetMin(i) + a_pStore->GetMax(i)) / 2.0f;
+		v3Sum += v3Center;
+		v3SumSquared += v3Center * v3Center;
+	}
+	vector3 v3Variance = ZERO_V3;
+	if (uCount > 0)
+	{
+		//squared in float, past 65535 boxes the count squared does not fit a uint
+		float fCount = static_cast<float>(uCount);
+		v3Variance = v3SumSquared / fCount - (v3Sum * v3Sum) / (fCount * fCount);
+	}
+	m_uAxis = 0;
+	if (v3Variance.y > v3Variance[m_uAxis])
+		m_uAxis = 1;
+	if (v3Variance.z > v3Variance[m_uAxis])
+		m_uAxis = 2;
+
+	m_lIndex.resize(uCount);
+	for (uint i = 0; i < uCount; ++i)
+		m_lIndex[i] = i;
+	uint uAxis = m_uAxis;
+	std::sort(m_lIndex.begin(), m_lIndex.end(), [a_pStore, uAxis](uint a, uint b)
+	{
+		return a_pStore->GetMin(a)[uAxis] < a_pStore->GetMin(b)[uAxis];
+	});
+	m_lMin.resize(uCount);
+	m_lMax.resize(uCount);
+}
+void Simplex::MySweepAndPrune::InsertionSort(void)
+{
+	m_uSwapCount = 0;
+	uint uCount = m_lIndex.size();
+	for (uint i = 1; i < uCount; ++i)
+	{
+		float fMin = m_lMin[i];
+		float fMax = m_lMax[i];
+		uint uIndex = m_lIndex[i];
+		uint j = i;
+		while (j > 0 && m_lMin[j - 1] > fMin)
+		{
+			m_lMin[j] = m_lMin[j - 1];
+			m_lMax[j] = m_lMax[j - 1];
+			m_lIndex[j] = m_lIndex[j - 1];
+			--j;
+		}
+		m_uSwapCount += i - j;
+		m_lMin[j] = fMin;
+		m_lMax[j] = fMax;
+		m_lIndex[j] = uIndex;
+	}
+}
+void Simplex::MySweepAndPrune::Update(MyAABBStore* a_pStore, std::vector<uint>& a_lPair)
+{
+	uint uCount = a_pStore->GetCount();
+
+	//entities were added or removed, the old order means nothing
+	if (m_lIndex.size() != uCount)
+		Rebuild(a_pStore);
+
+	//the boxes moved since last frame, read them in last frame's order and fix it
+	for (uint i = 0; i < uCount; ++i)
+	{
+		m_lMin[i] = a_pStore->GetMin(m_lIndex[i])[m_uAxis];
+		m_lMax[i] = a_pStore->GetMax(m_lIndex[i])[m_uAxis];
+	}
+	InsertionSort();
+
+	//a box can only overlap the ones that start before it ends
+	for (uint i = 0; i < uCount; ++i)
+	{
+		uint uIndex = m_lIndex[i];
+		vector3 v3Min = a_pStore->GetMin(uIndex);
+		vector3 v3Max = a_pStore->GetMax(uIndex);
+		for (uint j = i + 1; j < uCount && m_lMin[j] <= m_lMax[i]; ++j)
+		{
+			uint uOther = m_lIndex[j];
+			vector3 v3OtherMin = a_pStore->GetMin(uOther);
+			vector3 v3OtherMax = a_pStore->GetMax(uOther);
+			if (v3Max.x < v3OtherMin.x || v3Min.x > v3OtherMax.x ||
+				v3Max.y < v3OtherMin.y || v3Min.y > v3OtherMax.y ||
+				v3Max.z < v3OtherMin.z || v3Min.z > v3OtherMax.z)
+				continue;
+			a_lPair.push_back(uIndex);
+			a_lPair.push_back(uOther);
+		}
+	}
+}
@@ -0,0 +1,69 @@
+/*----------------------------------------------
+Programmer: Alberto Bobadilla (labigm@gmail.com)
+Date: 2017/07
+----------------------------------------------*/
+#ifndef __MYSWEEPANDPRUNE_H_
+#define __MYSWEEPANDPRUNE_H_
+
+#include "MyAABBStore.h"
+
+namespace Simplex
+{
+
+//Sort and sweep broad phase, keeps the boxes sorted along one axis between frames
+class MySweepAndPrune
+{
+	uint m_uAxis = 0; //axis the boxes are sorted along
+	std::vector<uint> m_lIndex; //index of the boxes (in the store) sorted by their minimum on the axis
+	std::vector<float> m_lMin; //minimum on the axis of each sorted box
+	std::vector<float> m_lMax; //maximum on the axis of each sorted box
+	uint m_uSwapCount = 0; //swaps the last insertion sort needed
+public:
+	/*
+	USAGE: Forgets the sorted order, the next update sorts from scratch
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Clear(void);
+	/*
+	USAGE: Sorts the boxes again and sweeps them to find the overlapping pairs. While the
+	number of boxes stays the same the previous order is reused and fixed with an insertion
+	sort, which is close to linear when the boxes only moved a little
+	ARGUMENTS:
+	-	MyAABBStore* a_pStore -> boxes to sort
+	-	std::vector<uint>& a_lPair -> list the overlapping pairs are appended to, two
+		indices per pair
+	OUTPUT: ---
+	*/
+	void Update(MyAABBStore* a_pStore, std::vector<uint>& a_lPair);
+	/*
+	USAGE: Gets the axis the boxes are sorted along
+	ARGUMENTS: ---
+	OUTPUT: 0 for x, 1 for y, 2 for z
+	*/
+	uint GetAxis(void);
+	/*
+	USAGE: Gets the number of swaps the last insertion sort needed
+	ARGUMENTS: ---
+	OUTPUT: swap count
+	*/
+	uint GetSwapCount(void);
+
+private:
+	/*
+	USAGE: Sorts every box from scratch along the axis their centers spread the most
+	ARGUMENTS: MyAABBStore* a_pStore -> boxes to sort
+	OUTPUT: ---
+	*/
+	void Rebuild(MyAABBStore* a_pStore);
+	/*
+	USAGE: Restores the order of the sorted boxes after they moved
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void InsertionSort(void);
+};//class
+
+} //namespace Simplex
+
+#endif //__MYSWEEPANDPRUNE_H_
@@ -0,0 +1,115 @@
+#include "MyThreadPool.h"
+using namespace Simplex;
+//  MyThreadPool
+Simplex::MyThreadPool* Simplex::MyThreadPool::m_pInstance = nullptr;
+void Simplex::MyThreadPool::Init(void)
+{
+	m_uJobSize = 0;
+	m_uJobNumber = 0;
+	m_uBusyWorkers = 0;
+	m_uNextIndex = 0;
+	m_bQuit = false;
+
+	//the thread calling ParallelFor works too, so one less worker than cores
+	uint uCores = std::thread::hardware_concurrency();
+	for (uint i = 1; i < uCores; ++i)
+	{
+		m_lWorker.push_back(std::thread(&MyThreadPool::WorkerLoop, this, i));
+	}
+}
+void Simplex::MyThreadPool::Release(void)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_bQuit = true;
+	}
+	m_WakeWorkers.notify_all();
+	for (uint i = 0; i < m_lWorker.size(); ++i)
+	{
+		m_lWorker[i].join();
+	}
+	m_lWorker.clear();
+}
+Simplex::MyThreadPool* Simplex::MyThreadPool::GetInstance()
+{
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new MyThreadPool();
+	}
+	return m_pInstance;
+}
+void Simplex::MyThreadPool::ReleaseInstance()
+{
+	if (m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+}
+//The big 3
+Simplex::MyThreadPool::MyThreadPool(){Init();}
+Simplex::MyThreadPool::MyThreadPool(MyThreadPool const& a_pOther){ }
+Simplex::MyThreadPool& Simplex::MyThreadPool::operator=(MyThreadPool const& a_pOther) { return *this; }
+Simplex::MyThreadPool::~MyThreadPool(){Release();};
+// other methods
+uint Simplex::MyThreadPool::GetThreadCount(void)
+{
+	return m_lWorker.size() + 1;
+}
+void Simplex::MyThreadPool::ParallelFor(uint a_uCount, std::function<void(uint, uint)> a_fTask)
+{
+	if (a_uCount == 0)
+		return;
+
+	//not worth waking anyone up
+	if (a_uCount == 1 || m_lWorker.size() == 0)
+	{
+		for (uint i = 0; i < a_uCount; ++i)
+			a_fTask(i, 0);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_fJob = a_fTask;
+		m_uJobSize = a_uCount;
+		m_uNextIndex = 0;
+		m_uBusyWorkers = m_lWorker.size();
+		++m_uJobNumber;
+	}
+	m_WakeWorkers.notify_all();
+
+	RunJob(0);
+
+	//the job is only done once every worker stopped touching it
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_JobDone.wait(lock, [this] { return m_uBusyWorkers == 0; });
+	m_fJob = nullptr;
+}
+void Simplex::MyThreadPool::WorkerLoop(uint a_uThread)
+{
+	uint uLastJob = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WakeWorkers.wait(lock, [this, uLastJob] { return m_bQuit || m_uJobNumber != uLastJob; });
+			if (m_bQuit)
+				return;
+			uLastJob = m_uJobNumber;
+		}
+
+		RunJob(a_uThread);
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (--m_uBusyWorkers == 0)
+			m_JobDone.notify_one();
+	}
+}
+void Simplex::MyThreadPool::RunJob(uint a_uThread)
+{
+	for (uint i = m_uNextIndex++; i < m_uJobSize; i = m_uNextIndex++)
+	{
+		m_fJob(i, a_uThread);
+	}
+}
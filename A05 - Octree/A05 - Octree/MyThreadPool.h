@@ -0,0 +1,119 @@
+/*----------------------------------------------
+Programmer: Alberto Bobadilla (labigm@gmail.com)
+Date: 2017/07
+----------------------------------------------*/
+#ifndef __MYTHREADPOOL_H_
+#define __MYTHREADPOOL_H_
+
+#include "Simplex\Simplex.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Simplex
+{
+
+//System Class
+class MyThreadPool
+{
+	static MyThreadPool* m_pInstance; // Singleton pointer
+
+	std::vector<std::thread> m_lWorker; //worker threads, the calling thread also works as thread 0
+	std::mutex m_Mutex; //guards the job state below
+	std::condition_variable m_WakeWorkers; //signaled when a job starts or the pool shuts down
+	std::condition_variable m_JobDone; //signaled when the last worker leaves a job
+
+	std::function<void(uint, uint)> m_fJob; //task run for each index of the current job
+	uint m_uJobSize = 0; //number of indices in the current job
+	uint m_uJobNumber = 0; //increases with every job so sleeping workers know there is a new one
+	uint m_uBusyWorkers = 0; //workers still inside the current job
+	std::atomic<uint> m_uNextIndex; //next index of the current job to hand out
+	bool m_bQuit = false; //tells the workers to finish
+public:
+	/*
+	Usage: Gets the singleton pointer
+	Arguments: ---
+	Output: singleton pointer
+	*/
+	static MyThreadPool* GetInstance();
+	/*
+	Usage: Releases the content of the singleton, joining the workers
+	Arguments: ---
+	Output: ---
+	*/
+	static void ReleaseInstance(void);
+	/*
+	USAGE: Gets the number of threads that run jobs, counting the calling thread
+	ARGUMENTS: ---
+	OUTPUT: number of threads
+	*/
+	uint GetThreadCount(void);
+	/*
+	USAGE: Runs the task once for every index in [0, a_uCount) spread over the threads and
+	returns once all of them are done. Indices are handed out one at a time so uneven tasks
+	balance themselves
+	ARGUMENTS:
+	-	uint a_uCount -> number of indices
+	-	std::function<void(uint, uint)> a_fTask -> task, gets the index and the number of
+		the thread running it (in [0, GetThreadCount()))
+	OUTPUT: ---
+	*/
+	void ParallelFor(uint a_uCount, std::function<void(uint, uint)> a_fTask);
+
+private:
+	/*
+	Usage: constructor
+	Arguments: ---
+	Output: class object instance
+	*/
+	MyThreadPool(void);
+	/*
+	Usage: copy constructor
+	Arguments: class object to copy
+	Output: class object instance
+	*/
+	MyThreadPool(MyThreadPool const& a_pOther);
+	/*
+	Usage: copy assignment operator
+	Arguments: class object to copy
+	Output: ---
+	*/
+	MyThreadPool& operator=(MyThreadPool const& a_pOther);
+	/*
+	Usage: destructor
+	Arguments: ---
+	Output: ---
+	*/
+	~MyThreadPool(void);
+	/*
+	Usage: Starts the worker threads
+	Arguments: ---
+	Output: ---
+	*/
+	void Init(void);
+	/*
+	Usage: Stops and joins the worker threads
+	Arguments: ---
+	Output: ---
+	*/
+	void Release(void);
+	/*
+	Usage: Loop of each worker, waits for jobs and runs its share of them
+	Arguments: uint a_uThread -> number of the thread
+	Output: ---
+	*/
+	void WorkerLoop(uint a_uThread);
+	/*
+	Usage: Takes indices of the current job until there are none left
+	Arguments: uint a_uThread -> number of the thread
+	Output: ---
+	*/
+	void RunJob(uint a_uThread);
+};//class
+
+} //namespace Simplex
+
+#endif //__MYTHREADPOOL_H_